@@ -0,0 +1,257 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "parser/lexer.hpp"
+#include "source.hpp"
+
+//-------------------------------------------------------------------------------------------
+// Allocation counting
+//-------------------------------------------------------------------------------------------
+
+namespace {
+
+  std::atomic<std::size_t> allocations{0};
+
+  void *counted_alloc(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto *ptr = std::malloc(size == 0 ? 1 : size)) {
+      return ptr;
+    }
+    throw std::bad_alloc{};
+  }
+
+} // namespace
+
+void *operator new(std::size_t size) {
+  return counted_alloc(size);
+}
+
+void *operator new[](std::size_t size) {
+  return counted_alloc(size);
+}
+
+void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+//-------------------------------------------------------------------------------------------
+// Benchmark
+//-------------------------------------------------------------------------------------------
+
+namespace {
+
+  enum class Mode {
+    eTokenize,
+    eBuffer,
+    eParallel,
+  };
+
+  struct Options {
+    std::vector<std::string> corpora;
+    std::size_t              runs = 5;
+    Mode                     mode = Mode::eTokenize;
+    std::string              json_path;
+  };
+
+  struct Run {
+    std::size_t bytes;
+    std::size_t tokens;
+    std::size_t allocations;
+    double      seconds;
+
+    [[nodiscard]] double mb_per_s() const {
+      return static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds;
+    }
+
+    [[nodiscard]] double tokens_per_s() const {
+      return static_cast<double>(tokens) / seconds;
+    }
+
+    [[nodiscard]] double allocations_per_token() const {
+      return tokens ? static_cast<double>(allocations) / static_cast<double>(tokens) : 0.0;
+    }
+  };
+
+  char const *mode_name(Mode mode) {
+    switch (mode) {
+    case Mode::eTokenize:
+      return "tokenize";
+    case Mode::eBuffer:
+      return "buffer";
+    case Mode::eParallel:
+      return "parallel";
+    }
+    return "unknown";
+  }
+
+  [[noreturn]] void usage(char const *argv0) {
+    std::cerr << "usage: " << argv0
+              << " [--runs N] [--mode tokenize|buffer|parallel] [--json PATH] CORPUS...\n";
+    std::exit(EXIT_FAILURE);
+  }
+
+  Options parse_options(int argc, char const *argv[]) {
+    Options opts{};
+    for (int i = 1; i < argc; ++i) {
+      auto arg = std::string_view{argv[i]};
+      if (arg == "--runs" and i + 1 < argc) {
+        opts.runs = std::stoul(argv[++i]);
+      } else if (arg == "--mode" and i + 1 < argc) {
+        auto mode = std::string_view{argv[++i]};
+        if (mode == "tokenize") {
+          opts.mode = Mode::eTokenize;
+        } else if (mode == "buffer") {
+          opts.mode = Mode::eBuffer;
+        } else if (mode == "parallel") {
+          opts.mode = Mode::eParallel;
+        } else {
+          usage(argv[0]);
+        }
+      } else if (arg == "--json" and i + 1 < argc) {
+        opts.json_path = argv[++i];
+      } else if (arg.starts_with("--")) {
+        usage(argv[0]);
+      } else {
+        opts.corpora.emplace_back(arg);
+      }
+    }
+
+    if (opts.corpora.empty() or opts.runs == 0) {
+      usage(argv[0]);
+    }
+    return opts;
+  }
+
+  Run run_once(claire::Source const &source, Mode mode) {
+    auto        lexer  = claire::parser::Lexer{source};
+    std::size_t tokens = 0;
+
+    auto allocs_before = allocations.load(std::memory_order_relaxed);
+    auto start         = std::chrono::steady_clock::now();
+
+    switch (mode) {
+    case Mode::eTokenize:
+      tokens = lexer.tokenize().size();
+      break;
+    case Mode::eBuffer:
+      tokens = lexer.tokenize_buffer().size();
+      break;
+    case Mode::eParallel:
+      tokens = lexer.tokenize_parallel().size();
+      break;
+    }
+
+    auto stop   = std::chrono::steady_clock::now();
+    auto allocs = allocations.load(std::memory_order_relaxed) - allocs_before;
+
+    return {source.size(), tokens, allocs, std::chrono::duration<double>(stop - start).count()};
+  }
+
+  // JSON string literal of `str`, escaping quotes, backslashes and control characters
+  std::string json_string(std::string_view str) {
+    static constexpr char hex[] = "0123456789abcdef";
+
+    std::string result{"\""};
+    for (auto ch : str) {
+      auto byte = static_cast<unsigned char>(ch);
+      switch (ch) {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      case '\t':
+        result += "\\t";
+        break;
+      default:
+        if (byte < 0x20) {
+          result += "\\u00";
+          result += hex[byte >> 4];
+          result += hex[byte & 0xf];
+        } else {
+          result += ch;
+        }
+        break;
+      }
+    }
+    result += '"';
+    return result;
+  }
+
+  void write_json(std::ostream &os, std::string const &corpus, Mode mode, std::size_t index,
+    Run const &run) {
+    // One object per line, so results of successive invocations can be appended
+    os << std::setprecision(6) << std::fixed << "{\"corpus\": " << json_string(corpus)
+       << ", \"mode\": " << json_string(mode_name(mode)) << ", \"run\": " << index
+       << ", \"bytes\": " << run.bytes << ", \"tokens\": " << run.tokens
+       << ", \"allocations\": " << run.allocations << ", \"seconds\": " << run.seconds
+       << ", \"mb_per_s\": " << run.mb_per_s() << ", \"tokens_per_s\": " << run.tokens_per_s()
+       << ", \"allocations_per_token\": " << run.allocations_per_token() << "}\n";
+  }
+
+} // namespace
+
+int main(int argc, char const *argv[]) {
+  auto opts = parse_options(argc, argv);
+
+  std::ofstream json{};
+  if (not opts.json_path.empty()) {
+    json.open(opts.json_path, std::ios::app);
+    if (not json) {
+      std::cerr << "Unable to open '" << opts.json_path << "'\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  for (auto const &corpus : opts.corpora) {
+    auto source = claire::Source{corpus};
+
+    // Warm up page cache, interner and scan kernel dispatch
+    run_once(source, opts.mode);
+
+    std::vector<Run> runs{};
+    for (std::size_t i = 0; i < opts.runs; ++i) {
+      runs.push_back(run_once(source, opts.mode));
+      if (json.is_open()) {
+        write_json(json, corpus, opts.mode, i, runs.back());
+      }
+    }
+
+    std::sort(runs.begin(), runs.end(),
+      [](Run const &lhs, Run const &rhs) { return lhs.seconds < rhs.seconds; });
+    auto const &median = runs[runs.size() / 2];
+
+    std::cout << corpus << " (" << mode_name(opts.mode) << ", median of " << runs.size()
+              << "): " << std::fixed << std::setprecision(1) << median.mb_per_s() << " MB/s, "
+              << std::setprecision(0) << median.tokens_per_s() << " tokens/s, "
+              << std::setprecision(4) << median.allocations_per_token()
+              << " allocations/token\n";
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -1,4 +1,12 @@
 #!/usr/bin/env python3
+#
+# usage: generate_ast_node_registry.py src/clrc/parser
+#
+# Writes ast_registry.hpp, included by ast.hpp ahead of the node classes, and
+# ast_visitor.hpp, which needs them complete.
+
+import os
+import sys
 
 AST_NODE_TYPES = [
     "ASTNode",
@@ -9,24 +17,77 @@ AST_NODE_TYPES = [
     "IdentifierSeq",
     "ExpressionSequence",
     "NamespaceAccessExpr",
+    "ModuleDecl",
+    "OpenDecl",
+    "FunctionBody",
+    "FunctionDef",
+    "ExternDecl",
+    "ModuleAccessExpr",
+    "NumeralExpr",
+    "UnaryExpr",
+    "BinaryExpr",
 ]
 
-CODE_TEMPLATE = """// This code is auto-generated by generate_ast_node_registry.py, do not manually modify!!!
+REGISTRY_TEMPLATE = """// This code is auto-generated by generate_ast_node_registry.py, do not manually modify!!!
 #pragma once
-#include <variant>
-#include "../visitor.hpp"
+#include <cstdint>
 
 namespace claire::parser {{
 {}
 
-using ASTNodeVariant = std::variant<{}>;
+enum class NodeKind : std::uint8_t {{
+{}}};
+
+template <typename NodeType>
+struct NodeKindOf;
+
+{}
+/// Kind stored in every node of type `NodeType`
+template <typename NodeType>
+inline constexpr NodeKind node_kind = NodeKindOf<NodeType>::value;
+
+}} // namespace claire::parser
+"""
 
-template <typename R>
-class ASTVisitor : public Visitor<R, {}> {{
+VISITOR_TEMPLATE = """// This code is auto-generated by generate_ast_node_registry.py, do not manually modify!!!
+#pragma once
+#include "ast.hpp"
+#include "flat_ast.hpp"
+
+namespace claire::parser {{
+
+/// Base of AST passes, dispatching on the kind of each node without virtual calls
+///
+/// `Derived` provides an `operator()` for each node type it handles, and brings in the
+/// `ASTNode` fallback of this class with a using-declaration. Every call is direct, so
+/// the compiler is free to inline the overloads into `visit`.
+///
+/// Nodes of a `FlatAST` are dispatched the same way, as `FlatAST::Ref`s typed after the
+/// node they were flattened from. Overloads taking a `node_ref` handle both.
+template <typename Derived, typename R>
+class ASTVisitor {{
 
 public:
-  R operator()(ASTNode const *) override {{
-    return nullptr;
+  R visit(ASTNode const *node) {{
+    auto &self = static_cast<Derived &>(*this);
+    switch (node->kind()) {{
+{}    }}
+    return self(node);
+  }}
+
+  R visit(FlatAST::NodeRef node) {{
+    auto &self = static_cast<Derived &>(*this);
+    switch (node.kind()) {{
+{}    }}
+    return self(FlatAST::Ref<ASTNode>{{node}});
+  }}
+
+  R operator()(ASTNode const *) {{
+    return R{{}};
+  }}
+
+  R operator()(FlatAST::NodeRef) {{
+    return R{{}};
   }}
 
 }};
@@ -35,14 +96,32 @@ public:
 """
 
 if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        sys.exit(f"usage: {sys.argv[0]} <output directory>")
+
     forward_decls = ""
-    variant_types = []
+    kinds = ""
+    kind_of = ""
+    cases = ""
+    flat_cases = ""
 
     for node_type in AST_NODE_TYPES:
         forward_decls += f"class {node_type};\n"
-        variant_types.append(f"{node_type} const *")
-
-    variant_types = ",".join(variant_types)
-    template_types = ",".join(AST_NODE_TYPES)
+        kinds += f"  e{node_type},\n"
+        kind_of += (f"template <>\nstruct NodeKindOf<{node_type}> {{\n"
+                    f"  static constexpr auto value = NodeKind::e{node_type};\n}};\n\n")
+        if node_type != "ASTNode":
+            cases += (f"    case NodeKind::e{node_type}:\n"
+                      f"      return self(static_cast<{node_type} const *>(node));\n")
+            flat_cases += (f"    case NodeKind::e{node_type}:\n"
+                           f"      return self(FlatAST::Ref<{node_type}>{{node}});\n")
+    cases += "    case NodeKind::eASTNode:\n      break;\n"
+    flat_cases += "    case NodeKind::eASTNode:\n      break;\n"
 
-    print(CODE_TEMPLATE.format(forward_decls, variant_types, template_types))
+    outputs = {
+        "ast_registry.hpp": REGISTRY_TEMPLATE.format(forward_decls, kinds, kind_of),
+        "ast_visitor.hpp": VISITOR_TEMPLATE.format(cases, flat_cases),
+    }
+    for fname, code in outputs.items():
+        with open(os.path.join(sys.argv[1], fname), "w") as f:
+            f.write(code)
@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""Generates a synthetic Claire corpus for benchmarking the lexer.
+
+The output mixes the constructs that stress distinct lexer paths: long and deeply
+namespaced identifiers, long string literals, pipelines of `|>` and `::` operators,
+numerals and heavily indented nested blocks. String literals carry some non-ASCII text.
+Every generated file lexes without errors.
+
+usage: generate_lexer_corpus.py OUTPUT [--size MIB] [--seed SEED] [--vocabulary N]
+"""
+
+import argparse
+import random
+
+WORDS = [
+    "value", "buffer", "result", "index", "count", "node", "tree", "parser", "token",
+    "module", "stream", "state", "context", "symbol", "table", "entry", "offset", "length",
+    "source", "target", "config", "handler", "visitor", "scope", "frame", "cache",
+]
+
+MODULES = ["std", "IO", "Core", "List", "Map", "String", "Math", "Async", "Net", "Fs"]
+
+# Non-ASCII text in string literals, as found in user-facing messages
+PROSE = ["größe", "naïve", "café", "значение", "名前", "→", "✓"]
+
+TYPES = ["Integer", "u32", "binary", "String", "Bool"]
+
+OPERATORS = ["+", "<", ">", "=", "."]
+
+INDENT = "  "
+
+
+class Generator:
+    def __init__(self, rng, vocabulary):
+        self.rng = rng
+        self.names = sorted({self.make_identifier() for _ in range(vocabulary)})
+        self.rng.shuffle(self.names)
+
+    def make_identifier(self):
+        words = self.rng.sample(WORDS, self.rng.randint(1, 5))
+        name = "_".join(words)
+        if self.rng.random() < 0.2:
+            name += str(self.rng.randint(0, 999))
+        return name
+
+    def identifier(self):
+        # Few names are used all over the place, most only here and there
+        rank = int(self.rng.paretovariate(1.2)) - 1
+        return self.names[rank % len(self.names)]
+
+    def qualified(self):
+        path = self.rng.sample(MODULES, self.rng.randint(0, 4))
+        return "::".join(path + [self.identifier()])
+
+    def string(self):
+        length = self.rng.choice([8, 16, 64, 256, 1024])
+        words = []
+        while sum(len(w) + 1 for w in words) < length:
+            words.append(self.rng.choice(WORDS + MODULES + PROSE))
+        return '"' + " ".join(words) + '"'
+
+    def atom(self):
+        roll = self.rng.random()
+        if roll < 0.5:
+            return self.qualified()
+        if roll < 0.7:
+            return str(self.rng.randint(0, 10 ** self.rng.randint(1, 12)))
+        if roll < 0.85:
+            return self.string()
+        return self.call(depth=1)
+
+    def call(self, depth=0):
+        args = [self.expression(depth + 1) for _ in range(self.rng.randint(0, 3))]
+        return f"{self.qualified()}({', '.join(args)})"
+
+    def expression(self, depth=0):
+        if depth > 2:
+            return self.atom()
+
+        roll = self.rng.random()
+        if roll < 0.3:
+            stages = [self.call(depth) for _ in range(self.rng.randint(1, 4))]
+            return " |> ".join([self.atom()] + stages)
+        if roll < 0.6:
+            operands = [self.atom() for _ in range(self.rng.randint(2, 4))]
+            return f" {self.rng.choice(OPERATORS)} ".join(operands)
+        return self.atom()
+
+    def block(self, level, lines):
+        indent = INDENT * level
+        roll = self.rng.random()
+
+        if level < 12 and roll < 0.25:
+            lines.append(f"{indent}if {self.expression()}")
+            for _ in range(self.rng.randint(1, 3)):
+                self.block(level + 1, lines)
+            lines.append(f"{indent}else")
+            self.block(level + 1, lines)
+        elif level < 12 and roll < 0.4:
+            lines.append(f"{indent}{{")
+            for _ in range(self.rng.randint(1, 4)):
+                self.block(level + 1, lines)
+            lines.append(f"{indent}}}")
+        elif roll < 0.7:
+            lines.append(f"{indent}let {self.identifier()} = {self.expression()};")
+        else:
+            lines.append(f"{indent}{self.call()};")
+
+    def function(self):
+        params = " ".join(
+            f"\\{self.identifier()}: {self.rng.choice(TYPES)}"
+            for _ in range(self.rng.randint(0, 3))
+        )
+        lines = [f"let {self.identifier()} {params}: {self.rng.choice(TYPES)} ="]
+        for _ in range(self.rng.randint(1, 6)):
+            self.block(1, lines)
+        lines.append("")
+        return "\n".join(lines) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("output", help="path of the generated .clr file")
+    parser.add_argument("--size", type=float, default=16, help="approximate size in MiB")
+    parser.add_argument("--seed", type=int, default=0, help="seed for reproducible corpora")
+    parser.add_argument(
+        "--vocabulary", type=int, default=4096, help="number of distinct identifiers"
+    )
+    args = parser.parse_args()
+
+    gen = Generator(random.Random(args.seed), args.vocabulary)
+    target = int(args.size * 1024 * 1024)
+
+    written = 0
+    with open(args.output, "w", encoding="utf-8", newline="\n") as out:
+        while written < target:
+            chunk = gen.function()
+            out.write(chunk)
+            written += len(chunk)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""Generates the XID_Start/XID_Continue lookup tables of the lexer.
+
+Usage: generate_xid_tables.py > src/clrc/parser/xid_tables.hpp
+
+Code points are split into blocks of 256, and blocks with identical properties are
+stored once. Python implements str.isidentifier() on top of XID_Start/XID_Continue,
+so the properties are those of the Unicode version of the running interpreter.
+"""
+
+import sys
+import unicodedata
+
+BLOCK_SIZE = 256
+
+CODE_TEMPLATE = """// This code is auto-generated by generate_xid_tables.py, do not manually modify!!!
+// Unicode {version}
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace claire::parser::xid {{
+
+// Properties of the code points of a block, one bit per code point
+struct Block {{
+  std::array<std::uint64_t, 4> start;
+  std::array<std::uint64_t, 4> cont;
+}};
+
+// Blocks past the end of the index have the properties of the last one
+inline constexpr std::array<std::uint8_t, {num_index}> index{{{{
+{index}
+}}}};
+
+inline constexpr std::array<Block, {num_blocks}> blocks{{{{
+{blocks}
+}}}};
+
+}} // namespace claire::parser::xid
+"""
+
+
+def xid_start(cp):
+    # '_' is an identifier start in Python only, the lexer handles ASCII itself
+    return cp != ord("_") and chr(cp).isidentifier()
+
+
+def xid_continue(cp):
+    return ("a" + chr(cp)).isidentifier()
+
+
+def bits(props):
+    words = []
+    for i in range(0, BLOCK_SIZE, 64):
+        word = sum(1 << j for j, prop in enumerate(props[i : i + 64]) if prop)
+        words.append(f"0x{word:016x}")
+    return ", ".join(words)
+
+
+def wrap(items, per_line):
+    lines = []
+    for i in range(0, len(items), per_line):
+        lines.append("  " + ", ".join(items[i : i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+if __name__ == "__main__":
+    blocks = {}
+    index = []
+    for base in range(0, sys.maxunicode + 1, BLOCK_SIZE):
+        cps = range(base, base + BLOCK_SIZE)
+        key = (tuple(map(xid_start, cps)), tuple(map(xid_continue, cps)))
+        index.append(blocks.setdefault(key, len(blocks)))
+
+    assert len(blocks) <= 256, "block indices must fit a byte"
+
+    # Drop the trailing run of blocks without identifier characters
+    while len(index) > 1 and index[-1] == index[-2]:
+        index.pop()
+
+    block_defs = [f"  Block{{{{{bits(start)}}},\n        {{{bits(cont)}}}}}," for start, cont in blocks]
+
+    print(
+        CODE_TEMPLATE.format(
+            version=unicodedata.unidata_version,
+            num_index=len(index),
+            index=wrap([str(i) for i in index], 24),
+            num_blocks=len(blocks),
+            blocks="\n".join(block_defs),
+        ),
+        end="",
+    )
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace claire {
+
+  /// Bump-pointer allocator whose objects all live until the arena itself goes away
+  ///
+  /// Objects are never destroyed one by one, which is only sound for trivially
+  /// destructible types: anything they own must come from the same arena. Memory is
+  /// handed back to the system in bulk, a handful of blocks at a time.
+  class Arena {
+    std::pmr::monotonic_buffer_resource resource_;
+
+  public:
+    static constexpr std::size_t initial_size = std::size_t{64} << 10;
+
+    Arena()
+      : resource_{initial_size} {
+    }
+
+    Arena(Arena const &)            = delete;
+    Arena &operator=(Arena const &) = delete;
+
+    template <typename T, typename... Args>
+    T *make(Args &&...args) {
+      static_assert(std::is_trivially_destructible_v<T>, "arena objects are never destroyed");
+      return ::new (resource_.allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    /// Copies `items` into the arena
+    template <typename T>
+    std::span<T const> copy(std::span<T const> items) {
+      static_assert(std::is_trivially_destructible_v<T>, "arena objects are never destroyed");
+      if (items.empty()) {
+        return {};
+      }
+      auto *data = static_cast<T *>(resource_.allocate(items.size_bytes(), alignof(T)));
+      std::uninitialized_copy(items.begin(), items.end(), data);
+      return {data, items.size()};
+    }
+  };
+
+} // namespace claire
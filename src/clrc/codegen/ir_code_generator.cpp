@@ -33,11 +33,13 @@ namespace claire::codegen {
     return target_machine;
   }
 
-  IRCodeGenerator::IRCodeGenerator(std::string const &source_fname)
+  IRCodeGenerator::IRCodeGenerator(
+    std::string const &source_fname, parser::ModuleRegistry const *modules)
     : ctx_{}
     , mod_{"claire", ctx_}
     , builder_{ctx_}
-    , machine_{set_target_machine(mod_)} {
+    , machine_{set_target_machine(mod_)}
+    , modules_{modules} {
     mod_.setSourceFileName(source_fname);
   }
 
@@ -75,8 +77,8 @@ namespace claire::codegen {
 
     builder_.SetInsertPoint(llvm::BasicBlock::Create(ctx_, "entry", main));
 
-    for (auto const &child : prog->children()) {
-      std::visit(*this, child->as_variant());
+    for (auto const *child : prog->children()) {
+      visit(child);
     }
 
     constexpr auto int_size  = 32;
@@ -85,44 +87,61 @@ namespace claire::codegen {
     auto ret = llvm::APInt{int_size, 0, is_signed};
     return builder_.CreateRet(llvm::ConstantInt::get(ctx_, ret));
   }
-  //
-  //  llvm::Value *IRCodeGenerator::operator()(parser::ModuleDecl const *decl) {
-  //    mod_fns_[decl->id()] = {};
-  //
-  //    for (auto const &child : decl->children()) {
-  //      auto callee = std::visit(*this, child->as_variant());
-  //
-  //      // TODO(rihtwis-weard): nested visitors
-  //      if (auto edecl = dynamic_cast<parser::ExternDecl const *>(child.get())) {
-  //        mod_fns_[decl->id()][edecl->id()] = callee;
-  //      }
-  //    }
-  //    return nullptr;
-  //  }
-  //
-  //  llvm::Value *IRCodeGenerator::operator()(parser::ExternDecl const *decl) {
-  //    // TODO(rihtwis-weard): `ExternDecl` allows generic typing and binding to any value,
-  //    //                      does not assume function type signature
-  //
-  //    auto result = builder_.getVoidTy();
-  //    if (decl->return_type() == "u32") {
-  //      result = builder_.getInt32Ty();
-  //    }
-  //
-  //    std::vector<llvm::Type *> params{};
-  //
-  //    for (auto const &arg : decl->args()) {
-  //      if (arg.type == "binary") {
-  //        params.push_back(builder_.getInt8PtrTy());
-  //      } else {
-  //        // TODO(rihtwis-weard): error handling because args don't matchup
-  //      }
-  //    }
-  //
-  //    auto fn = mod_.getOrInsertFunction(
-  //      decl->linkage_name(), llvm::FunctionType::get(result, params, false));
-  //    return fn.getCallee();
-  //  }
+
+  llvm::Value *IRCodeGenerator::operator()(parser::OpenDecl const *decl) {
+    auto const *module = modules_ ? modules_->find(decl->id()) : nullptr;
+    if (not module) {
+      std::cerr << "unknown module opened!\n";
+      return nullptr;
+    }
+
+    opened_[decl->id()] = module;
+    if (mod_fns_.contains(module)) {
+      return nullptr;
+    }
+
+    // Registered ahead of its declarations, which may open it back
+    mod_fns_[module] = {};
+    for (auto const *child : module->root()->children()) {
+      if (child->kind() == parser::NodeKind::eExternDecl) {
+        auto const *decl              = parser::node_cast<parser::ExternDecl>(child);
+        mod_fns_[module][child->id()] = declare(decl);
+      } else if (child->kind() == parser::NodeKind::eOpenDecl) {
+        visit(child);
+      }
+    }
+    return nullptr;
+  }
+
+  llvm::Value *IRCodeGenerator::operator()(parser::ExternDecl const *decl) {
+    return declare(decl).getCallee();
+  }
+
+  llvm::FunctionCallee IRCodeGenerator::declare(parser::ExternDecl const *decl) {
+    // TODO(rihtwis-weard): `ExternDecl` allows generic typing and binding to any value,
+    //                      does not assume function type signature
+
+    llvm::Type *result = builder_.getVoidTy();
+    if (decl->return_type().str() == "u32") {
+      result = builder_.getInt32Ty();
+    }
+
+    std::vector<llvm::Type *> params{};
+
+    for (auto const &arg : decl->args()) {
+      if (arg.type.str() == "binary") {
+        params.push_back(builder_.getInt8PtrTy());
+      } else if (arg.type.str() == "u32") {
+        params.push_back(builder_.getInt32Ty());
+      } else {
+        // TODO(rihtwis-weard): error handling because args don't matchup
+        return {};
+      }
+    }
+
+    return mod_.getOrInsertFunction(
+      decl->linkage_name(), llvm::FunctionType::get(result, params, false));
+  }
 
   // TODO(rihtwis-weard): error-handling
   llvm::Value *IRCodeGenerator::operator()(parser::StringExpr const *expr) {
@@ -133,32 +152,44 @@ namespace claire::codegen {
     // TODO(rihtwis-weard): can/should separate modules be compiled as separate object files?
     //                      or always/conditionally be inlined as AST?
 
-    // TODO(rihtwis-weard): nested visitors vs. if statements for function callee resolution?
-    //    if (auto ma_expr = dynamic_cast<parser::ModuleAccessExpr const *>(expr->callee())) {
-    //      auto value = mod_fns_.at(ma_expr->module_name()).at(ma_expr->id());
-    //
-    //      std::vector<llvm::Value *> args;
-    //      for (auto const &child : expr->children()) {
-    //        if (auto arg = std::visit(*this, child->as_variant()); arg) {
-    //          args.push_back(arg);
-    //        } else {
-    //          std::cerr << "failed to create function arg!\n";
-    //          return nullptr;
-    //        }
-    //      }
-    //
-    //      if (auto callee = mod_.getFunction(value->getName())) {
-    //        return builder_.CreateCall(callee, args, "calltmp");
-    //      } else {
-    //        std::cerr << "unknown function referenced!\n";
-    //        return nullptr;
-    //      }
-    //
-    //    } else {
-    //      std::cerr << "function callee type is unsupported or unknown!\n";
-    //      return nullptr;
-    //    }
-    return nullptr;
+    // `Module.function`, led by the name of an opened module
+    auto const *seq = parser::node_cast<parser::IdentifierSeq>(expr->callee());
+    auto        mod = seq ? opened_.find(seq->id()) : opened_.end();
+    if (mod == opened_.end()) {
+      std::cerr << "function callee type is unsupported or unknown!\n";
+      return nullptr;
+    }
+
+    parser::ASTNode const *member{};
+    for (auto const *child : seq->children()) {
+      if (child->kind() == parser::NodeKind::eIdentifierExpr) {
+        member = child;
+      }
+    }
+
+    auto const &fns    = mod_fns_.at(mod->second);
+    auto        found  = member ? fns.find(member->id()) : fns.end();
+    auto        callee = found != fns.end() ? found->second : llvm::FunctionCallee{};
+    if (not callee) {
+      std::cerr << "unknown function referenced!\n";
+      return nullptr;
+    }
+
+    std::vector<llvm::Value *> args;
+    for (auto const *seq_args : expr->children()) {
+      for (auto const *child : seq_args->children()) {
+        if (auto arg = visit(child); arg) {
+          args.push_back(arg);
+        } else {
+          std::cerr << "failed to create function arg!\n";
+          return nullptr;
+        }
+      }
+    }
+
+    // Called through the declared type, as the module may hold the name with another one
+    auto name = callee.getFunctionType()->getReturnType()->isVoidTy() ? "" : "calltmp";
+    return builder_.CreateCall(callee, args, name);
   }
 
 } // namespace claire::codegen
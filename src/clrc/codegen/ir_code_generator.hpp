@@ -15,21 +15,35 @@
 #include <robin_hood.h>
 
 #include "../parser/ast.hpp"
+#include "../parser/ast_visitor.hpp"
+#include "../parser/module_loader.hpp"
 
 namespace claire::codegen {
 
-  class IRCodeGenerator : public parser::ASTVisitor<llvm::Value *> {
+  class IRCodeGenerator : public parser::ASTVisitor<IRCodeGenerator, llvm::Value *> {
     llvm::LLVMContext    ctx_;
     llvm::Module         mod_;
     llvm::IRBuilder<>    builder_;
     llvm::TargetMachine *machine_;
 
-    robin_hood::unordered_map<std::string,
-      robin_hood::unordered_map<std::string, llvm::Value *>>
+    // Modules that `open` declarations are resolved against, if any
+    parser::ModuleRegistry const *modules_;
+
+    // Functions of every module lowered so far, keyed by the cached module rather than
+    // by name, so that a module is lowered once however many sources open it. Callees
+    // keep the type they were declared with, which their value alone lacks once it is a
+    // cast of a same-named function declared with another signature.
+    robin_hood::unordered_map<parser::Module const *,
+      robin_hood::unordered_map<Symbol, llvm::FunctionCallee>>
       mod_fns_;
 
+    // Modules opened so far by name
+    robin_hood::unordered_map<Symbol, parser::Module const *> opened_;
+
   public:
-    explicit IRCodeGenerator(std::string const &source_fname);
+    /// \param modules modules loaded along with the source, outliving the generator
+    explicit IRCodeGenerator(
+      std::string const &source_fname, parser::ModuleRegistry const *modules = nullptr);
 
     virtual ~IRCodeGenerator() = default;
 
@@ -37,20 +51,29 @@ namespace claire::codegen {
 
     std::string dumps() const;
 
+    /// \return module lowered so far
+    llvm::Module const &module() const {
+      return mod_;
+    }
+
     void emit_object_code();
 
-    llvm::Value *operator()(parser::ProgramDecl const *) override;
-//    llvm::Value *operator()(parser::ModuleDecl const *) override;
-//    llvm::Value *operator()(parser::ExternDecl const *) override;
-    llvm::Value *operator()(parser::StringExpr const *) override;
-    llvm::Value *operator()(parser::FunctionCallExpr const *) override;
+    llvm::Value *operator()(parser::ProgramDecl const *);
+    llvm::Value *operator()(parser::OpenDecl const *);
+    llvm::Value *operator()(parser::ExternDecl const *);
+    llvm::Value *operator()(parser::StringExpr const *);
+    llvm::Value *operator()(parser::FunctionCallExpr const *);
 
-//    llvm::Value *operator()(parser::ModuleAccessExpr const *) override {
+//    llvm::Value *operator()(parser::ModuleAccessExpr const *) {
 //      return nullptr;
 //    }
 
-    llvm::Value *operator()(parser::IdentifierExpr const *) override {
+    llvm::Value *operator()(parser::IdentifierExpr const *) {
       return nullptr;
     }
+
+  private:
+    /// \return callee declared by `decl`, null if its signature is not supported
+    llvm::FunctionCallee declare(parser::ExternDecl const *decl);
   };
 } // namespace claire::codegen
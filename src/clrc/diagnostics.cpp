@@ -0,0 +1,84 @@
+#include "diagnostics.hpp"
+
+#include <exception>
+#include <iterator>
+#include <ostream>
+
+#include "exception.hpp"
+#include "source_manager.hpp"
+
+namespace claire {
+
+  namespace {
+
+    /// \return the exception `diagnostic` is raised as, located within `source` if known
+    std::exception_ptr exception_of(Diagnostic const &diagnostic, Source const *source) {
+      auto const &[kind, loc, detail] = diagnostic;
+      auto offset                     = source ? source->offset(loc) : 0;
+      switch (kind) {
+      case DiagnosticKind::eUnexpectedEOF:
+        return std::make_exception_ptr(
+          source ? unexpected_eof{*source, offset} : unexpected_eof{});
+      case DiagnosticKind::eInvalidLexeme:
+        return std::make_exception_ptr(
+          source ? invalid_lexeme{*source, offset} : invalid_lexeme{});
+      case DiagnosticKind::eInvalidEncoding:
+        return std::make_exception_ptr(
+          source ? invalid_encoding{*source, offset} : invalid_encoding{});
+      case DiagnosticKind::eModuleNotFound:
+        return std::make_exception_ptr(source ? module_not_found{*source, offset, detail}
+                                              : module_not_found{detail});
+      case DiagnosticKind::eModuleNotLoaded:
+        return std::make_exception_ptr(source ? module_not_loaded{*source, offset, detail}
+                                              : module_not_loaded{detail});
+      default:
+        return std::make_exception_ptr(
+          source ? syntax_error{*source, offset, detail} : syntax_error{detail});
+      }
+    }
+
+  } // namespace
+
+  void Diagnostic::raise() const {
+    // Made while the source is resolved, as exceptions describe its location up front
+    std::rethrow_exception(SourceManager::global().resolve(
+      loc, [this](Source const *source) { return exception_of(*this, source); }));
+  }
+
+  std::ostream &operator<<(std::ostream &os, Diagnostic const &diagnostic) {
+    SourceManager::global().resolve(diagnostic.loc, [&](Source const *source) {
+      if (source) {
+        auto pos = source->position(source->offset(diagnostic.loc));
+        os << source->path() << ":" << pos.line << ":" << pos.col << ": ";
+      }
+    });
+
+    switch (diagnostic.kind) {
+    case DiagnosticKind::eUnexpectedEOF:
+      return os << "Unexpected end-of-file";
+    case DiagnosticKind::eInvalidLexeme:
+      return os << "Invalid lexeme";
+    case DiagnosticKind::eInvalidEncoding:
+      return os << "Invalid UTF-8";
+    case DiagnosticKind::eModuleNotFound:
+      return os << "Module not found: " << diagnostic.detail;
+    case DiagnosticKind::eModuleNotLoaded:
+      return os << "Module not loaded: " << diagnostic.detail;
+    default:
+      return os << "Syntax error: " << diagnostic.detail;
+    }
+  }
+
+  void Diagnostics::append(Diagnostics &&other) {
+    diagnostics_.insert(diagnostics_.end(), std::make_move_iterator(other.diagnostics_.begin()),
+      std::make_move_iterator(other.diagnostics_.end()));
+    other.diagnostics_.clear();
+  }
+
+  void Diagnostics::raise_first() const {
+    if (not diagnostics_.empty()) {
+      diagnostics_.front().raise();
+    }
+  }
+
+} // namespace claire
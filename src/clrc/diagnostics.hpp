@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "source_loc.hpp"
+
+namespace claire {
+
+  enum class DiagnosticKind : std::uint8_t {
+    eUnexpectedEOF,
+    eInvalidLexeme,
+    eInvalidEncoding,
+    eSyntaxError,
+    eModuleNotFound,
+    eModuleNotLoaded,
+  };
+
+  /// Error found while compiling, reported instead of thrown so that compilation can
+  /// carry on and find the errors that follow it
+  struct Diagnostic {
+    DiagnosticKind kind;
+    // Where the error was found, if known
+    SourceLoc      loc;
+    // What was expected for syntax errors, the name of the module for missing modules,
+    // the name of the module and why for modules that failed to load
+    std::string    detail;
+
+    /// Throws the exception the error was raised as before diagnostics were collected
+    [[noreturn]] void raise() const;
+
+    friend std::ostream &operator<<(std::ostream &os, Diagnostic const &diagnostic);
+  };
+
+  /// Sink collecting diagnostics in the order they were found
+  class Diagnostics {
+    std::vector<Diagnostic> diagnostics_;
+
+  public:
+    void report(Diagnostic diagnostic) {
+      diagnostics_.push_back(std::move(diagnostic));
+    }
+
+    void append(Diagnostics &&other);
+
+    [[nodiscard]] bool empty() const {
+      return diagnostics_.empty();
+    }
+
+    [[nodiscard]] std::size_t size() const {
+      return diagnostics_.size();
+    }
+
+    [[nodiscard]] Diagnostic const &operator[](std::size_t i) const {
+      return diagnostics_[i];
+    }
+
+    [[nodiscard]] auto begin() const {
+      return diagnostics_.begin();
+    }
+
+    [[nodiscard]] auto end() const {
+      return diagnostics_.end();
+    }
+
+    /// Raises the first diagnostic, if any, for callers that stop at the first error
+    void raise_first() const;
+  };
+
+} // namespace claire
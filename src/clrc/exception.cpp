@@ -1,13 +1,56 @@
 #include "exception.hpp"
 
+#include <cstring>
+
 namespace claire {
 
+  source_error::source_error(std::string const &path, int err)
+    : message_{"Unable to read source '" + path + "': " + std::strerror(err)} {
+  }
+
+  char const *source_error::what() const noexcept {
+    return message_.c_str();
+  }
+
+  static std::string locate(Source const &source, std::size_t offset) {
+    auto pos = source.position(offset);
+    return source.path() + ":" + std::to_string(pos.line) + ":" + std::to_string(pos.col);
+  }
+
+  unexpected_eof::unexpected_eof()
+    : message_{"Unexpected end-of-file"} {
+  }
+
+  unexpected_eof::unexpected_eof(Source const &source, std::size_t offset)
+    : message_{locate(source, offset) + ": Unexpected end-of-file"} {
+  }
+
   char const *unexpected_eof::what() const noexcept {
-    return "Unexpected end-of-file";
+    return message_.c_str();
+  }
+
+  invalid_lexeme::invalid_lexeme()
+    : message_{"Invalid lexeme"} {
+  }
+
+  invalid_lexeme::invalid_lexeme(Source const &source, std::size_t offset)
+    : message_{locate(source, offset) + ": Invalid lexeme"} {
   }
 
   char const *invalid_lexeme::what() const noexcept {
-    return "Invalid lexeme";
+    return message_.c_str();
+  }
+
+  invalid_encoding::invalid_encoding()
+    : message_{"Invalid UTF-8"} {
+  }
+
+  invalid_encoding::invalid_encoding(Source const &source, std::size_t offset)
+    : message_{locate(source, offset) + ": Invalid UTF-8"} {
+  }
+
+  char const *invalid_encoding::what() const noexcept {
+    return message_.c_str();
   }
 
   syntax_error::syntax_error()
@@ -18,8 +61,39 @@ namespace claire {
     : message_{"Syntax error: " + std::move(message)} {
   }
 
+  syntax_error::syntax_error(
+    Source const &source, std::size_t offset, std::string const &message)
+    : message_{locate(source, offset) + ": Syntax error: " + message} {
+  }
+
   char const *syntax_error::what() const noexcept {
     return message_.c_str();
   }
 
+  module_not_found::module_not_found(std::string const &name)
+    : message_{"Module not found: " + name} {
+  }
+
+  module_not_found::module_not_found(
+    Source const &source, std::size_t offset, std::string const &name)
+    : message_{locate(source, offset) + ": Module not found: " + name} {
+  }
+
+  char const *module_not_found::what() const noexcept {
+    return message_.c_str();
+  }
+
+  module_not_loaded::module_not_loaded(std::string const &reason)
+    : message_{"Module not loaded: " + reason} {
+  }
+
+  module_not_loaded::module_not_loaded(
+    Source const &source, std::size_t offset, std::string const &reason)
+    : message_{locate(source, offset) + ": Module not loaded: " + reason} {
+  }
+
+  char const *module_not_loaded::what() const noexcept {
+    return message_.c_str();
+  }
+
 } // namespace claire
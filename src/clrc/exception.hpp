@@ -3,15 +3,46 @@
 #include <exception>
 #include <string>
 
+#include "source.hpp"
+
 namespace claire {
 
+  class source_error : public std::exception {
+    std::string message_;
+
+  public:
+    source_error(std::string const &path, int err);
+
+    [[nodiscard]] char const *what() const noexcept override;
+  };
+
   class unexpected_eof : public std::exception {
+    std::string message_;
+
   public:
+    explicit unexpected_eof();
+    unexpected_eof(Source const &source, std::size_t offset);
+
     [[nodiscard]] char const *what() const noexcept override;
   };
 
   class invalid_lexeme : public std::exception {
+    std::string message_;
+
   public:
+    explicit invalid_lexeme();
+    invalid_lexeme(Source const &source, std::size_t offset);
+
+    [[nodiscard]] char const *what() const noexcept override;
+  };
+
+  class invalid_encoding : public std::exception {
+    std::string message_;
+
+  public:
+    explicit invalid_encoding();
+    invalid_encoding(Source const &source, std::size_t offset);
+
     [[nodiscard]] char const *what() const noexcept override;
   };
 
@@ -21,6 +52,27 @@ namespace claire {
   public:
     explicit syntax_error();
     explicit syntax_error(std::string message);
+    syntax_error(Source const &source, std::size_t offset, std::string const &message);
+
+    [[nodiscard]] char const *what() const noexcept override;
+  };
+
+  class module_not_found : public std::exception {
+    std::string message_;
+
+  public:
+    explicit module_not_found(std::string const &name);
+    module_not_found(Source const &source, std::size_t offset, std::string const &name);
+
+    [[nodiscard]] char const *what() const noexcept override;
+  };
+
+  class module_not_loaded : public std::exception {
+    std::string message_;
+
+  public:
+    explicit module_not_loaded(std::string const &reason);
+    module_not_loaded(Source const &source, std::size_t offset, std::string const &reason);
 
     [[nodiscard]] char const *what() const noexcept override;
   };
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cassert>
+#include <utility>
+#include <variant>
+
+namespace claire {
+
+  /// Error alternative of an `Expected`, as `std::unexpected`
+  template <typename E>
+  class Unexpected {
+    E error_;
+
+  public:
+    explicit Unexpected(E error)
+      : error_{std::move(error)} {
+    }
+
+    [[nodiscard]] E &&error() && {
+      return std::move(error_);
+    }
+  };
+
+  /// Either a value or the error that prevented producing it
+  ///
+  /// The subset of C++23's `std::expected` used throughout the compiler. Accessing the
+  /// alternative that is not held is a programming error rather than an exception, so
+  /// that results can be passed around in noexcept code.
+  template <typename T, typename E>
+  class Expected {
+    std::variant<T, E> storage_;
+
+  public:
+    Expected(T value)
+      : storage_{std::in_place_index<0>, std::move(value)} {
+    }
+
+    template <typename U>
+    Expected(Unexpected<U> error)
+      : storage_{std::in_place_index<1>, std::move(error).error()} {
+    }
+
+    [[nodiscard]] bool has_value() const noexcept {
+      return storage_.index() == 0;
+    }
+
+    explicit operator bool() const noexcept {
+      return has_value();
+    }
+
+    [[nodiscard]] T &value() & noexcept {
+      assert(has_value());
+      return *std::get_if<0>(&storage_);
+    }
+
+    [[nodiscard]] T const &value() const & noexcept {
+      assert(has_value());
+      return *std::get_if<0>(&storage_);
+    }
+
+    [[nodiscard]] T &&value() && noexcept {
+      assert(has_value());
+      return std::move(*std::get_if<0>(&storage_));
+    }
+
+    [[nodiscard]] E &error() & noexcept {
+      assert(not has_value());
+      return *std::get_if<1>(&storage_);
+    }
+
+    [[nodiscard]] E const &error() const & noexcept {
+      assert(not has_value());
+      return *std::get_if<1>(&storage_);
+    }
+
+    [[nodiscard]] E &&error() && noexcept {
+      assert(not has_value());
+      return std::move(*std::get_if<1>(&storage_));
+    }
+
+    T &operator*() & noexcept {
+      return value();
+    }
+
+    T const &operator*() const & noexcept {
+      return value();
+    }
+
+    T *operator->() noexcept {
+      return &value();
+    }
+
+    T const *operator->() const noexcept {
+      return &value();
+    }
+  };
+
+} // namespace claire
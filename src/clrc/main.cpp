@@ -1,30 +1,42 @@
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
 
 #include "codegen/ir_code_generator.hpp"
-#include "parser/lexer.hpp"
+#include "parser/module_interface.hpp"
+#include "parser/module_loader.hpp"
 #include "parser/parser.hpp"
 
 int main(int argc, char const *argv[]) {
   constexpr auto source_fname = "../../examples/hello_world.clr";
-
-  auto tokens = claire::parser::Lexer{source_fname}.tokenize();
-  for (auto const &tok : tokens) {
-    std::cout << tok << "\n";
-  }
-
-  std::size_t i{};
-  for (auto v : claire::parser::parse_trans) {
-    std::cout << "[" << i++ << "]: " << static_cast<int>(v) << "\n";
+  constexpr auto stdlib_path  = "../../src/std/";
+
+  // Precompiled interfaces of the modules opened, shared by every build of the user
+  auto const *cache_home = std::getenv("XDG_CACHE_HOME");
+  auto const *home       = std::getenv("HOME");
+  auto        cache_dir  = cache_home ? std::filesystem::path{cache_home}
+                           : home     ? std::filesystem::path{home} / ".cache"
+                                      : std::filesystem::temp_directory_path();
+
+  // Modules live as long as the cache
+  auto interfaces = claire::parser::ModuleInterfaceCache{cache_dir / "claire"};
+  auto cache      = claire::parser::ModuleCache{&interfaces};
+  auto loader     = claire::parser::ModuleLoader{{stdlib_path}, cache};
+  auto ast        = loader.load(source_fname);
+
+  // Report every error at once rather than stopping at the first one
+  if (not ast) {
+    for (auto const &diagnostic : ast.error()) {
+      std::cerr << diagnostic << "\n";
+    }
+    return EXIT_FAILURE;
   }
 
-  constexpr auto stdlib_path = "../../src/stdlib/";
-
-  auto ast = claire::parser::Parser{stdlib_path}.parse(tokens);
-
   std::unique_ptr<claire::codegen::IRCodeGenerator> code_generator =
-    std::make_unique<claire::codegen::IRCodeGenerator>(source_fname);
+    std::make_unique<claire::codegen::IRCodeGenerator>(
+      source_fname, &loader.registry());
 
-  std::visit(*code_generator, ast->as_variant());
+  code_generator->visit(ast.value().root());
 
   std::cout << code_generator->dumps() << "\n";
   code_generator->emit_object_code();
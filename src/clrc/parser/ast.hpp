@@ -5,257 +5,452 @@
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Value.h>
 #include <memory>
+#include <span>
 #include <utility>
-#include <vector>
 
+#include "../arena.hpp"
+#include "../source_loc.hpp"
+#include "../symbol.hpp"
 #include "ast_registry.hpp"
+#include "numeral.hpp"
+#include "token.hpp"
 
 namespace claire::parser {
 
+  /// Children of a node, in order, linked through their next sibling
+  class ASTChildren {
+    ASTNode const *first_;
+
+  public:
+    class iterator {
+      ASTNode const *node_;
+
+    public:
+      using value_type      = ASTNode const *;
+      using difference_type = std::ptrdiff_t;
+
+      iterator(ASTNode const *node = nullptr)
+        : node_{node} {
+      }
+
+      ASTNode const *operator*() const {
+        return node_;
+      }
+
+      iterator &operator++();
+
+      iterator operator++(int) {
+        auto prev = *this;
+        ++*this;
+        return prev;
+      }
+
+      bool operator==(iterator const &) const = default;
+    };
+
+    explicit ASTChildren(ASTNode const *first)
+      : first_{first} {
+    }
+
+    [[nodiscard]] iterator begin() const {
+      return first_;
+    }
+
+    [[nodiscard]] iterator end() const {
+      return {};
+    }
+
+    [[nodiscard]] bool empty() const {
+      return first_ == nullptr;
+    }
+  };
+
+  /// Base of all AST nodes, which are allocated from the arena of their `AST`
+  ///
+  /// Nodes own nothing outside of that arena, so that they can be freed in bulk without
+  /// running their destructors. They carry no vtable: their dynamic type is the
+  /// `NodeKind` they store, which `ASTVisitor` dispatches on.
   class ASTNode {
   protected:
-    std::string                           id_;
-    std::vector<std::unique_ptr<ASTNode>> children_;
+    Symbol    id_;
+    SourceLoc loc_;
+    NodeKind  kind_;
+    ASTNode  *first_child_{};
+    ASTNode  *last_child_{};
+    ASTNode  *next_sibling_{};
 
 #ifdef CTEST
-    std::size_t level_;
+    std::size_t level_{};
 #endif
 
-  public:
-#ifdef CTEST
-    explicit ASTNode(std::string id = "", std::size_t level = 0)
-      : id_{std::move(id)}
-      , level_{level} {
+    ASTNode(NodeKind kind, Symbol id)
+      : id_{id}
+      , kind_{kind} {
     }
-#else
-    explicit ASTNode(std::string id = "")
-      : id_{std::move(id)} {
+
+  public:
+    explicit ASTNode(Symbol id = {})
+      : ASTNode{NodeKind::eASTNode, id} {
     }
-#endif
 
-    void add(std::unique_ptr<ASTNode> &&node) {
+    void add(ASTNode *node) {
 #ifdef CTEST
       node->update_level(this);
 #endif
-      children_.emplace_back(std::move(node));
+      if (last_child_) {
+        last_child_->next_sibling_ = node;
+      } else {
+        first_child_ = node;
+      }
+      last_child_ = node;
     }
 
-    virtual ~ASTNode() = default;
+    [[nodiscard]] NodeKind kind() const {
+      return kind_;
+    }
 
-    [[nodiscard]] virtual std::string const &id() const {
+    [[nodiscard]] Symbol id() const {
       return id_;
     }
 
+    /// \return location of the first token of this node, if it was parsed from a source
+    [[nodiscard]] SourceLoc loc() const {
+      return loc_;
+    }
+
+    void set_loc(SourceLoc loc) {
+      loc_ = loc;
+    }
+
 #ifdef CTEST
-    [[nodiscard]] virtual std::size_t level() const {
+    [[nodiscard]] std::size_t level() const {
       return level_;
     }
 #endif
 
-    [[nodiscard]] virtual std::vector<std::unique_ptr<ASTNode>> const &children() const {
-      return children_;
+    [[nodiscard]] ASTChildren children() const {
+      return ASTChildren{first_child_};
     }
 
-    [[nodiscard]] virtual ASTNodeVariant as_variant() const {
-      return this;
+    [[nodiscard]] ASTNode const *next_sibling() const {
+      return next_sibling_;
     }
 
   private:
 #ifdef CTEST
     void update_level(ASTNode const *parent) {
       level_ = parent->level_ + 1;
-      for (auto const &child : children_) {
+      for (auto *child = first_child_; child; child = child->next_sibling_) {
         child->update_level(this);
       }
     }
 #endif
   };
 
-  class Decl : virtual public ASTNode {};
+  inline ASTChildren::iterator &ASTChildren::iterator::operator++() {
+    node_ = node_->next_sibling();
+    return *this;
+  }
 
-  class Expr : virtual public ASTNode {};
+  /// \return `node` as a `NodeType`, or nullptr if it is of another kind
+  template <typename NodeType>
+  NodeType const *node_cast(ASTNode const *node) {
+    if (node->kind() != node_kind<NodeType>) {
+      return nullptr;
+    }
+    return static_cast<NodeType const *>(node);
+  }
+
+  class Decl : public ASTNode {
+  protected:
+    using ASTNode::ASTNode;
+  };
+
+  class Expr : public ASTNode {
+  protected:
+    using ASTNode::ASTNode;
+  };
 
   class ProgramDecl : public Decl {
 
   public:
-    explicit ProgramDecl(std::string id)
-      : ASTNode{std::move(id)} {
-    }
-
-    [[nodiscard]] ASTNodeVariant as_variant() const override {
-      return this;
+    explicit ProgramDecl(Symbol id)
+      : Decl{NodeKind::eProgramDecl, id} {
     }
   };
 
   class ModuleDecl : public Decl {
   public:
-    explicit ModuleDecl(std::string id)
-      : ASTNode{std::move(id)} {
+    explicit ModuleDecl(Symbol id)
+      : Decl{NodeKind::eModuleDecl, id} {
     }
+  };
 
-    [[nodiscard]] ASTNodeVariant as_variant() const override {
-      return this;
+  /// `open` of a module, named after it
+  class OpenDecl : public Decl {
+  public:
+    explicit OpenDecl(Symbol module_name)
+      : Decl{NodeKind::eOpenDecl, module_name} {
     }
   };
 
   struct FunctionArg {
-    std::string name;
-    std::string type;
+    Symbol name;
+    Symbol type;
   };
 
   class FunctionBody : public Decl {
   public:
     FunctionBody()
-      : ASTNode{} {
-    }
-
-    [[nodiscard]] ASTNodeVariant as_variant() const override {
-      return this;
+      : Decl{NodeKind::eFunctionBody, {}} {
     }
   };
 
   class FunctionDef : public Decl {
-    std::unique_ptr<IdentifierExpr> name_;
-    std::vector<FunctionArg>        args_;
+    IdentifierExpr              *name_;
+    std::span<FunctionArg const> args_;
+    Symbol                       return_type_;
+    Expr                        *guard_;
+    FunctionBody                *body_;
 
   public:
-    FunctionDef(std::string id, std::unique_ptr<IdentifierExpr> &&name,
-      std::vector<FunctionArg> &&args, std::unique_ptr<ASTNode> &&body)
-      : ASTNode{std::move(id)}
-      , name_{std::move(name)}
-      , args_{std::move(args)} {
+    /// \param args arguments, in the arena of the node
+    /// \param return_type empty if left to inference
+    /// \param guard condition the definition applies under, if any, child before `body`
+    FunctionDef(Symbol id, IdentifierExpr *name, std::span<FunctionArg const> args,
+      Symbol return_type, FunctionBody *body, Expr *guard = nullptr)
+      : Decl{NodeKind::eFunctionDef, id}
+      , name_{name}
+      , args_{args}
+      , return_type_{return_type}
+      , guard_{guard}
+      , body_{body} {
+
+      if (guard) {
+        add(guard);
+      }
+      add(body);
+    }
+
+    [[nodiscard]] std::span<FunctionArg const> args() const {
+      return args_;
+    }
+
+    [[nodiscard]] Symbol return_type() const {
+      return return_type_;
+    }
 
-      add(std::move(body));
+    [[nodiscard]] Expr const *guard() const {
+      return guard_;
     }
 
-    [[nodiscard]] ASTNodeVariant as_variant() const override {
-      return this;
+    [[nodiscard]] FunctionBody const *body() const {
+      return body_;
     }
   };
 
   class StringExpr : public Expr {
   public:
-    explicit StringExpr(std::string id)
-      : ASTNode{std::move(id)} {
-    }
-
-    [[nodiscard]] ASTNodeVariant as_variant() const override {
-      return this;
+    explicit StringExpr(Symbol id)
+      : Expr{NodeKind::eStringExpr, id} {
     }
 
     [[nodiscard]] std::string value() const {
-      return id_.substr(1, id_.size() - 2);
+      auto literal = id_.str();
+      return std::string{literal.substr(1, literal.size() - 2)};
     }
   };
 
   class ExternDecl : public Decl {
-    std::vector<FunctionArg>    args_;
-    std::string                 return_type_;
-    std::unique_ptr<StringExpr> linkage_name_;
+    std::span<FunctionArg const> args_;
+    Symbol                       return_type_;
+    StringExpr                  *linkage_name_;
 
   public:
-    ExternDecl(std::string id, std::vector<FunctionArg> &&args, std::string return_type,
-      std::unique_ptr<StringExpr> &&linkage_name)
-      : ASTNode{std::move(id)}
-      , args_{std::move(args)}
-      , return_type_{std::move(return_type)}
-      , linkage_name_{std::move(linkage_name)} {
-    }
-
-    [[nodiscard]] ASTNodeVariant as_variant() const override {
-      return this;
+    /// \param args arguments, in the arena of the node
+    ExternDecl(Symbol id, std::span<FunctionArg const> args, Symbol return_type,
+      StringExpr *linkage_name)
+      : Decl{NodeKind::eExternDecl, id}
+      , args_{args}
+      , return_type_{return_type}
+      , linkage_name_{linkage_name} {
     }
 
-    [[nodiscard]] std::vector<FunctionArg> const &args() const {
+    [[nodiscard]] std::span<FunctionArg const> args() const {
       return args_;
     }
 
-    [[nodiscard]] std::string return_type() const {
+    [[nodiscard]] Symbol return_type() const {
       return return_type_;
     }
 
     [[nodiscard]] std::string linkage_name() const {
       return linkage_name_->value();
     }
+
+    [[nodiscard]] StringExpr const *linkage_name_literal() const {
+      return linkage_name_;
+    }
   };
 
   class IdentifierExpr : public Expr {
 
   public:
-    explicit IdentifierExpr(std::string id)
-      : ASTNode{std::move(id)} {
-    }
-
-    [[nodiscard]] ASTNodeVariant as_variant() const override {
-      return this;
+    explicit IdentifierExpr(Symbol id)
+      : Expr{NodeKind::eIdentifierExpr, id} {
     }
   };
 
   class IdentifierSeq : public Expr {
   public:
-    [[nodiscard]] ASTNodeVariant as_variant() const override {
-      return this;
+    explicit IdentifierSeq(Symbol id = {})
+      : Expr{NodeKind::eIdentifierSeq, id} {
     }
   };
 
   class NamespaceAccessExpr : public Expr {
-    std::unique_ptr<IdentifierExpr> base_;
+    IdentifierExpr *base_;
 
   public:
-    explicit NamespaceAccessExpr(std::unique_ptr<IdentifierExpr> &&base)
-      : ASTNode(base->id())
-      , base_{std::move(base)} {
-    }
-
-    [[nodiscard]] ASTNodeVariant as_variant() const override {
-      return this;
+    explicit NamespaceAccessExpr(IdentifierExpr *base)
+      : Expr{NodeKind::eNamespaceAccessExpr, base->id()}
+      , base_{base} {
+      loc_ = base_->loc();
     }
   };
 
   class ModuleAccessExpr : public Expr {
-    std::vector<std::string> module_names_;
+    Symbol module_name_;
 
   public:
     explicit ModuleAccessExpr(IdentifierExpr const &expr)
-      : ASTNode{expr.id()} {
+      : Expr{NodeKind::eModuleAccessExpr, expr.id()} {
     }
 
-    [[nodiscard]] ASTNodeVariant as_variant() const override {
-      return this;
-    }
-
-    [[nodiscard]] std::string const &module_name() const {
+    [[nodiscard]] Symbol module_name() const {
       // TODO(rihtwis-weard): support for nested modules
-      return module_names_[0];
+      return module_name_;
     }
 
-    void grow(std::string const &id) {
-      module_names_.push_back(id_);
+    void grow(Symbol id) {
+      if (module_name_.empty()) {
+        module_name_ = id_;
+      }
       id_ = id;
     }
   };
 
   class FunctionCallExpr : public Expr {
-    std::unique_ptr<Expr> callee_;
+    Expr *callee_;
 
   public:
-    explicit FunctionCallExpr(std::unique_ptr<Expr> &&callee)
-      : callee_{std::move(callee)} {
+    explicit FunctionCallExpr(Expr *callee)
+      : Expr{NodeKind::eFunctionCallExpr, {}}
+      , callee_{callee} {
+      loc_ = callee_->loc();
     }
 
-    [[nodiscard]] ASTNodeVariant as_variant() const override {
-      return this;
+    [[nodiscard]] Expr const *callee() const {
+      return callee_;
     }
+  };
 
-    [[nodiscard]] Expr const *callee() const {
-      return callee_.get();
+  class NumeralExpr : public Expr {
+    NumeralValue value_;
+
+  public:
+    /// \param spelling text of the literal, as written
+    NumeralExpr(Symbol spelling, NumeralValue value)
+      : Expr{NodeKind::eNumeralExpr, spelling}
+      , value_{value} {
+    }
+
+    [[nodiscard]] NumeralValue value() const {
+      return value_;
+    }
+  };
+
+  /// Prefix operator applied to its only child
+  class UnaryExpr : public Expr {
+    TokenKind op_;
+
+  public:
+    UnaryExpr(TokenKind op, Expr *operand)
+      : Expr{NodeKind::eUnaryExpr, {}}
+      , op_{op} {
+      add(operand);
+    }
+
+    [[nodiscard]] TokenKind op() const {
+      return op_;
+    }
+
+    [[nodiscard]] Expr const *operand() const {
+      return static_cast<Expr const *>(first_child_);
+    }
+  };
+
+  /// Infix operator applied to its two children, in order
+  class BinaryExpr : public Expr {
+    TokenKind op_;
+
+  public:
+    BinaryExpr(TokenKind op, Expr *lhs, Expr *rhs)
+      : Expr{NodeKind::eBinaryExpr, {}}
+      , op_{op} {
+      loc_ = lhs->loc();
+      add(lhs);
+      add(rhs);
+    }
+
+    [[nodiscard]] TokenKind op() const {
+      return op_;
+    }
+
+    [[nodiscard]] Expr const *lhs() const {
+      return static_cast<Expr const *>(first_child_);
+    }
+
+    [[nodiscard]] Expr const *rhs() const {
+      return static_cast<Expr const *>(last_child_);
     }
   };
 
   class ExpressionSequence : public ASTNode {
   public:
-    [[nodiscard]] ASTNodeVariant as_variant() const override {
-      return this;
+    ExpressionSequence()
+      : ASTNode{NodeKind::eExpressionSequence, {}} {
+    }
+  };
+
+  /// Nodes parsed from a compilation unit, all owned by a single arena
+  ///
+  /// The whole tree is freed at once along with the arena, without walking it.
+  class AST {
+    std::unique_ptr<Arena> arena_;
+    ASTNode               *root_;
+
+  public:
+    AST()
+      : arena_{std::make_unique<Arena>()}
+      , root_{nullptr} {
+    }
+
+    template <typename NodeType, typename... Args>
+    NodeType *make(Args &&...args) {
+      return arena_->make<NodeType>(std::forward<Args>(args)...);
+    }
+
+    [[nodiscard]] Arena &arena() {
+      return *arena_;
+    }
+
+    [[nodiscard]] ASTNode const *root() const {
+      return root_;
+    }
+
+    void set_root(ASTNode *root) {
+      root_ = root;
     }
   };
 
@@ -1,19 +1,30 @@
 #pragma once
 
 #include "ast.hpp"
+#include "ast_visitor.hpp"
+#include "flat_ast.hpp"
 
 namespace claire::parser {
 
-  class ASTPrettyPrinter : ASTVisitor<std::string> {
+  class ASTPrettyPrinter : public ASTVisitor<ASTPrettyPrinter, std::string> {
 
   public:
-    std::string pretty_print(ASTNode *node) {
+    std::string pretty_print(ASTNode const *node) {
       auto repr = indent(node->level());
-      auto name = std::visit(*this, node->as_variant());
+      auto name = visit(node);
       repr += "└──" + name + "\n";
 
-      for (auto const &child : node->children()) {
-        repr += pretty_print(child.get());
+      for (auto const *child : node->children()) {
+        repr += pretty_print(child);
+      }
+      return repr;
+    }
+
+    /// Same output as for the tree `ast` was flattened from, in a single linear scan
+    std::string pretty_print(FlatAST const &ast) {
+      std::string repr{};
+      for (auto node : ast) {
+        repr += indent(node.level()) + "└──" + visit(node) + "\n";
       }
       return repr;
     }
@@ -26,57 +37,77 @@ namespace claire::parser {
       return s;
     }
 
-    std::string operator()(ASTNode const *) override {
+    std::string operator()(ASTNode const *) {
+      return "ASTNode: root";
+    }
+
+    std::string operator()(FlatAST::NodeRef) {
       return "ASTNode: root";
     }
 
-    std::string operator()(ProgramDecl const *) override {
+    std::string operator()(node_ref<ProgramDecl> auto) {
       return "ProgramDecl";
     }
 
-    //    std::string operator()(ModuleDecl const *decl) override {
-    //      return "ModuleDecl: " + decl->id();
-    //    }
+    std::string operator()(node_ref<ModuleDecl> auto decl) {
+      return "ModuleDecl: " + std::string{decl->id().str()};
+    }
 
-    std::string operator()(StringExpr const *expr) override {
-      return "StringLiteral: " + expr->id();
+    std::string operator()(node_ref<OpenDecl> auto decl) {
+      return "OpenDecl: " + std::string{decl->id().str()};
     }
 
-    //    std::string operator()(ExternDecl const *decl) override {
-    //      return "ExternDecl: " + decl->id();
-    //    }
+    std::string operator()(node_ref<StringExpr> auto expr) {
+      return "StringLiteral: " + std::string{expr->id().str()};
+    }
+
+    std::string operator()(node_ref<ExternDecl> auto decl) {
+      return "ExternDecl: " + std::string{decl->id().str()};
+    }
 
-    std::string operator()(IdentifierExpr const *expr) override {
-      return "IdentifierExpr: " + expr->id();
+    std::string operator()(node_ref<IdentifierExpr> auto expr) {
+      return "IdentifierExpr: " + std::string{expr->id().str()};
     }
 
-    //    std::string operator()(ModuleAccessExpr const *expr) override {
+    //    std::string operator()(ModuleAccessExpr const *expr) {
     //      return expr->module_name() + "." + expr->id();
     //    }
 
-    std::string operator()(FunctionCallExpr const *expr) override {
-      return "FunctionCallExpr: " + expr->callee()->id();
+    std::string operator()(node_ref<FunctionCallExpr> auto expr) {
+      return "FunctionCallExpr: " + std::string{expr->callee()->id().str()};
     }
 
-    //    std::string operator()(FunctionDef const *decl) override {
-    //      return "FunctionDef: " + decl->id();
-    //    }
-    //
-    //    std::string operator()(FunctionBody const *decl) override {
-    //      return "FunctionBody";
-    //    }
+    std::string operator()(node_ref<FunctionDef> auto decl) {
+      return "FunctionDef: " + std::string{decl->id().str()};
+    }
+
+    std::string operator()(node_ref<FunctionBody> auto) {
+      return "FunctionBody";
+    }
 
-    std::string operator()(IdentifierSeq const *seq) override {
+    std::string operator()(node_ref<IdentifierSeq> auto seq) {
       return "IdentifierSequence";
     }
 
-    std::string operator()(NamespaceAccessExpr const *expr) override {
-      return "NamespaceAccessExpr: " + expr->id();
+    std::string operator()(node_ref<NamespaceAccessExpr> auto expr) {
+      return "NamespaceAccessExpr: " + std::string{expr->id().str()};
     }
 
-    std::string operator()(ExpressionSequence const *expr) override {
+    std::string operator()(node_ref<ExpressionSequence> auto expr) {
       return "ExpressionSequence";
     }
+
+    std::string operator()(node_ref<NumeralExpr> auto expr) {
+      return "NumeralExpr: " + std::string{expr->id().str()};
+    }
+
+    std::string operator()(node_ref<UnaryExpr> auto expr) {
+      return "UnaryExpr: " + std::string{spelling_of(expr->op())};
+    }
+
+    std::string operator()(node_ref<BinaryExpr> auto expr) {
+      return "BinaryExpr: " + std::string{spelling_of(expr->op())};
+    }
   };
 
 } // namespace claire::parser
@@ -1,7 +1,6 @@
 // This code is auto-generated by generate_ast_node_registry.py, do not manually modify!!!
 #pragma once
-#include <variant>
-#include "../visitor.hpp"
+#include <cstdint>
 
 namespace claire::parser {
 class ASTNode;
@@ -12,19 +11,128 @@ class FunctionCallExpr;
 class IdentifierSeq;
 class ExpressionSequence;
 class NamespaceAccessExpr;
+class ModuleDecl;
+class OpenDecl;
+class FunctionBody;
+class FunctionDef;
+class ExternDecl;
+class ModuleAccessExpr;
+class NumeralExpr;
+class UnaryExpr;
+class BinaryExpr;
 
 
-using ASTNodeVariant = std::variant<ASTNode const *,ProgramDecl const *,IdentifierExpr const *,StringExpr const *,FunctionCallExpr const *,IdentifierSeq const *,ExpressionSequence const *,NamespaceAccessExpr const *>;
+enum class NodeKind : std::uint8_t {
+  eASTNode,
+  eProgramDecl,
+  eIdentifierExpr,
+  eStringExpr,
+  eFunctionCallExpr,
+  eIdentifierSeq,
+  eExpressionSequence,
+  eNamespaceAccessExpr,
+  eModuleDecl,
+  eOpenDecl,
+  eFunctionBody,
+  eFunctionDef,
+  eExternDecl,
+  eModuleAccessExpr,
+  eNumeralExpr,
+  eUnaryExpr,
+  eBinaryExpr,
+};
 
-template <typename R>
-class ASTVisitor : public Visitor<R, ASTNode,ProgramDecl,IdentifierExpr,StringExpr,FunctionCallExpr,IdentifierSeq,ExpressionSequence,NamespaceAccessExpr> {
+template <typename NodeType>
+struct NodeKindOf;
 
-public:
-  R operator()(ASTNode const *) override {
-    return nullptr;
-  }
+template <>
+struct NodeKindOf<ASTNode> {
+  static constexpr auto value = NodeKind::eASTNode;
+};
 
+template <>
+struct NodeKindOf<ProgramDecl> {
+  static constexpr auto value = NodeKind::eProgramDecl;
 };
 
-} // namespace claire::parser
+template <>
+struct NodeKindOf<IdentifierExpr> {
+  static constexpr auto value = NodeKind::eIdentifierExpr;
+};
+
+template <>
+struct NodeKindOf<StringExpr> {
+  static constexpr auto value = NodeKind::eStringExpr;
+};
+
+template <>
+struct NodeKindOf<FunctionCallExpr> {
+  static constexpr auto value = NodeKind::eFunctionCallExpr;
+};
+
+template <>
+struct NodeKindOf<IdentifierSeq> {
+  static constexpr auto value = NodeKind::eIdentifierSeq;
+};
+
+template <>
+struct NodeKindOf<ExpressionSequence> {
+  static constexpr auto value = NodeKind::eExpressionSequence;
+};
+
+template <>
+struct NodeKindOf<NamespaceAccessExpr> {
+  static constexpr auto value = NodeKind::eNamespaceAccessExpr;
+};
+
+template <>
+struct NodeKindOf<ModuleDecl> {
+  static constexpr auto value = NodeKind::eModuleDecl;
+};
+
+template <>
+struct NodeKindOf<OpenDecl> {
+  static constexpr auto value = NodeKind::eOpenDecl;
+};
 
+template <>
+struct NodeKindOf<FunctionBody> {
+  static constexpr auto value = NodeKind::eFunctionBody;
+};
+
+template <>
+struct NodeKindOf<FunctionDef> {
+  static constexpr auto value = NodeKind::eFunctionDef;
+};
+
+template <>
+struct NodeKindOf<ExternDecl> {
+  static constexpr auto value = NodeKind::eExternDecl;
+};
+
+template <>
+struct NodeKindOf<ModuleAccessExpr> {
+  static constexpr auto value = NodeKind::eModuleAccessExpr;
+};
+
+template <>
+struct NodeKindOf<NumeralExpr> {
+  static constexpr auto value = NodeKind::eNumeralExpr;
+};
+
+template <>
+struct NodeKindOf<UnaryExpr> {
+  static constexpr auto value = NodeKind::eUnaryExpr;
+};
+
+template <>
+struct NodeKindOf<BinaryExpr> {
+  static constexpr auto value = NodeKind::eBinaryExpr;
+};
+
+
+/// Kind stored in every node of type `NodeType`
+template <typename NodeType>
+inline constexpr NodeKind node_kind = NodeKindOf<NodeType>::value;
+
+} // namespace claire::parser
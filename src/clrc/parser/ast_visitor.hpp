@@ -0,0 +1,112 @@
+// This code is auto-generated by generate_ast_node_registry.py, do not manually modify!!!
+#pragma once
+#include "ast.hpp"
+#include "flat_ast.hpp"
+
+namespace claire::parser {
+
+/// Base of AST passes, dispatching on the kind of each node without virtual calls
+///
+/// `Derived` provides an `operator()` for each node type it handles, and brings in the
+/// `ASTNode` fallback of this class with a using-declaration. Every call is direct, so
+/// the compiler is free to inline the overloads into `visit`.
+///
+/// Nodes of a `FlatAST` are dispatched the same way, as `FlatAST::Ref`s typed after the
+/// node they were flattened from. Overloads taking a `node_ref` handle both.
+template <typename Derived, typename R>
+class ASTVisitor {
+
+public:
+  R visit(ASTNode const *node) {
+    auto &self = static_cast<Derived &>(*this);
+    switch (node->kind()) {
+    case NodeKind::eProgramDecl:
+      return self(static_cast<ProgramDecl const *>(node));
+    case NodeKind::eIdentifierExpr:
+      return self(static_cast<IdentifierExpr const *>(node));
+    case NodeKind::eStringExpr:
+      return self(static_cast<StringExpr const *>(node));
+    case NodeKind::eFunctionCallExpr:
+      return self(static_cast<FunctionCallExpr const *>(node));
+    case NodeKind::eIdentifierSeq:
+      return self(static_cast<IdentifierSeq const *>(node));
+    case NodeKind::eExpressionSequence:
+      return self(static_cast<ExpressionSequence const *>(node));
+    case NodeKind::eNamespaceAccessExpr:
+      return self(static_cast<NamespaceAccessExpr const *>(node));
+    case NodeKind::eModuleDecl:
+      return self(static_cast<ModuleDecl const *>(node));
+    case NodeKind::eOpenDecl:
+      return self(static_cast<OpenDecl const *>(node));
+    case NodeKind::eFunctionBody:
+      return self(static_cast<FunctionBody const *>(node));
+    case NodeKind::eFunctionDef:
+      return self(static_cast<FunctionDef const *>(node));
+    case NodeKind::eExternDecl:
+      return self(static_cast<ExternDecl const *>(node));
+    case NodeKind::eModuleAccessExpr:
+      return self(static_cast<ModuleAccessExpr const *>(node));
+    case NodeKind::eNumeralExpr:
+      return self(static_cast<NumeralExpr const *>(node));
+    case NodeKind::eUnaryExpr:
+      return self(static_cast<UnaryExpr const *>(node));
+    case NodeKind::eBinaryExpr:
+      return self(static_cast<BinaryExpr const *>(node));
+    case NodeKind::eASTNode:
+      break;
+    }
+    return self(node);
+  }
+
+  R visit(FlatAST::NodeRef node) {
+    auto &self = static_cast<Derived &>(*this);
+    switch (node.kind()) {
+    case NodeKind::eProgramDecl:
+      return self(FlatAST::Ref<ProgramDecl>{node});
+    case NodeKind::eIdentifierExpr:
+      return self(FlatAST::Ref<IdentifierExpr>{node});
+    case NodeKind::eStringExpr:
+      return self(FlatAST::Ref<StringExpr>{node});
+    case NodeKind::eFunctionCallExpr:
+      return self(FlatAST::Ref<FunctionCallExpr>{node});
+    case NodeKind::eIdentifierSeq:
+      return self(FlatAST::Ref<IdentifierSeq>{node});
+    case NodeKind::eExpressionSequence:
+      return self(FlatAST::Ref<ExpressionSequence>{node});
+    case NodeKind::eNamespaceAccessExpr:
+      return self(FlatAST::Ref<NamespaceAccessExpr>{node});
+    case NodeKind::eModuleDecl:
+      return self(FlatAST::Ref<ModuleDecl>{node});
+    case NodeKind::eOpenDecl:
+      return self(FlatAST::Ref<OpenDecl>{node});
+    case NodeKind::eFunctionBody:
+      return self(FlatAST::Ref<FunctionBody>{node});
+    case NodeKind::eFunctionDef:
+      return self(FlatAST::Ref<FunctionDef>{node});
+    case NodeKind::eExternDecl:
+      return self(FlatAST::Ref<ExternDecl>{node});
+    case NodeKind::eModuleAccessExpr:
+      return self(FlatAST::Ref<ModuleAccessExpr>{node});
+    case NodeKind::eNumeralExpr:
+      return self(FlatAST::Ref<NumeralExpr>{node});
+    case NodeKind::eUnaryExpr:
+      return self(FlatAST::Ref<UnaryExpr>{node});
+    case NodeKind::eBinaryExpr:
+      return self(FlatAST::Ref<BinaryExpr>{node});
+    case NodeKind::eASTNode:
+      break;
+    }
+    return self(FlatAST::Ref<ASTNode>{node});
+  }
+
+  R operator()(ASTNode const *) {
+    return R{};
+  }
+
+  R operator()(FlatAST::NodeRef) {
+    return R{};
+  }
+
+};
+
+} // namespace claire::parser
@@ -0,0 +1,202 @@
+#include "edit_buffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "lexer.hpp"
+
+namespace claire::parser {
+
+  namespace {
+
+    // Room left in a gap whenever it grows, so that typing does not grow it every time
+    constexpr std::size_t min_gap = 64;
+
+  } // namespace
+
+  EditBuffer::EditBuffer(Source const &source)
+    : path_{source.path()}
+    , text_{}
+    , text_gap_begin_{source.size()}
+    , text_gap_end_{source.size() + min_gap}
+    , tokens_{}
+    , token_gap_begin_{0}
+    , token_gap_end_{0} {
+    text_.reserve(source.size() + min_gap);
+    text_.insert(text_.end(), source.data(), source.data() + source.size());
+    text_.resize(source.size() + min_gap);
+
+    // Errors are reported along with the tokens of snapshots
+    auto diagnostics = Diagnostics{};
+    auto tokens      = Lexer{source}.tokenize_buffer(diagnostics);
+
+    tokens_.reserve(tokens.size() + min_gap);
+    for (std::size_t i = 0; i < tokens.size(); ++i) {
+      tokens_.push_back({tokens.kind(i), tokens.offset(i), tokens.length(i), tokens.symbol(i),
+        tokens.value(i)});
+    }
+    token_gap_begin_ = tokens_.size();
+    tokens_.resize(tokens_.size() + min_gap);
+    token_gap_end_ = tokens_.size();
+  }
+
+  std::size_t EditBuffer::edit(TextEdit const &edit) {
+    // Tokens ending before the edit were decided by text preceding it. The last of them
+    // is lexed again though: the byte right after a token may be consumed along with it
+    // (e.g. a quote ending an identifier), so only token starts are known to be lexed
+    // from an initiating state.
+    std::size_t keep = 0;
+    for (auto lo = std::size_t{0}, hi = num_tokens(); lo < hi;) {
+      auto mid = lo + (hi - lo) / 2;
+      if (end(mid) < edit.offset) {
+        keep = lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    keep -= keep > 0;
+
+    // Before the first token there is only layout
+    auto restart = keep < num_tokens() and end(keep) < edit.offset ? offset(keep) : 0;
+
+    // Tokens from the restart on are past the gap, where the edit does not move them.
+    // Those starting within the relexed text are dropped up front, which leaves old
+    // tokens starting past the edit only.
+    move_token_gap(keep);
+
+    auto old_start = [&]() { return size() - tokens_[token_gap_end_].offset; };
+    while (token_gap_end_ < tokens_.size() and old_start() < edit.offset + edit.removed) {
+      ++token_gap_end_;
+    }
+
+    replace_text(edit);
+
+    // Lexing is back in step with the old tokens past the next line feed, at the latest
+    auto new_edit_end = edit.offset + edit.inserted.size();
+    auto window_end   = new_edit_end;
+    while (window_end < size() and at(window_end++) != '\n') {
+    }
+
+    // Detached, so that edits never use up the location space
+    auto window = Source::detached(path_, text(restart, window_end));
+    auto lexer  = Lexer{window};
+
+    std::size_t lexed = 0;
+    while (auto tok = lexer.next_token()) {
+      auto offset = restart + static_cast<std::size_t>(tok->repr.data() - window.data());
+
+      if (offset >= new_edit_end) {
+        // Old tokens that started before this one can no longer line up
+        while (token_gap_end_ < tokens_.size() and old_start() < offset) {
+          ++token_gap_end_;
+        }
+
+        // From here on the text, and thus the tokens, are the same as before
+        if (token_gap_end_ < tokens_.size() and old_start() == offset) {
+          return lexed;
+        }
+      }
+
+      insert_token(*tok, offset);
+      ++lexed;
+    }
+
+    // Old tokens past the line feed were lexed from a clean state too
+    while (token_gap_end_ < tokens_.size() and old_start() < window_end) {
+      ++token_gap_end_;
+    }
+    return lexed;
+  }
+
+  std::string EditBuffer::text() const {
+    return text(0, size());
+  }
+
+  TokenBuffer EditBuffer::tokens(Source const &source) const {
+    auto buffer = TokenBuffer{source.data(), source.loc(0)};
+    buffer.reserve(num_tokens());
+    for (std::size_t i = 0; i < num_tokens(); ++i) {
+      auto const &entry =
+        tokens_[i < token_gap_begin_ ? i : i + token_gap_end_ - token_gap_begin_];
+      buffer.push_back(entry.kind, static_cast<std::uint32_t>(offset(i)), entry.length,
+        entry.symbol, entry.value);
+    }
+    return buffer;
+  }
+
+  std::string EditBuffer::text(std::size_t begin, std::size_t end) const {
+    auto gap   = text_gap_end_ - text_gap_begin_;
+    auto split = std::clamp(text_gap_begin_, begin, end);
+
+    std::string result{};
+    result.reserve(end - begin);
+    result.append(text_.data() + begin, split - begin);
+    result.append(text_.data() + split + gap, end - split);
+    return result;
+  }
+
+  std::size_t EditBuffer::offset(std::size_t i) const {
+    if (i < token_gap_begin_) {
+      return tokens_[i].offset;
+    }
+    return size() - tokens_[i + token_gap_end_ - token_gap_begin_].offset;
+  }
+
+  std::size_t EditBuffer::end(std::size_t i) const {
+    auto const &entry =
+      tokens_[i < token_gap_begin_ ? i : i + token_gap_end_ - token_gap_begin_];
+    return offset(i) + entry.length;
+  }
+
+  void EditBuffer::replace_text(TextEdit const &edit) {
+    // Move the gap to the edit, shifting only the text in between
+    if (edit.offset < text_gap_begin_) {
+      auto n = text_gap_begin_ - edit.offset;
+      std::memmove(text_.data() + text_gap_end_ - n, text_.data() + edit.offset, n);
+      text_gap_begin_ -= n;
+      text_gap_end_ -= n;
+    } else if (edit.offset > text_gap_begin_) {
+      auto n = edit.offset - text_gap_begin_;
+      std::memmove(text_.data() + text_gap_begin_, text_.data() + text_gap_end_, n);
+      text_gap_begin_ += n;
+      text_gap_end_ += n;
+    }
+
+    text_gap_end_ += edit.removed;
+
+    if (auto gap = text_gap_end_ - text_gap_begin_; gap < edit.inserted.size()) {
+      auto grow = std::max(size(), edit.inserted.size()) + min_gap;
+      text_.insert(text_.begin() + static_cast<std::ptrdiff_t>(text_gap_end_), grow, '\0');
+      text_gap_end_ += grow;
+    }
+    std::memcpy(text_.data() + text_gap_begin_, edit.inserted.data(), edit.inserted.size());
+    text_gap_begin_ += edit.inserted.size();
+  }
+
+  void EditBuffer::move_token_gap(std::size_t i) {
+    // Offsets flip between the start and the end of the text as tokens cross the gap
+    auto size = static_cast<std::uint32_t>(this->size());
+    while (token_gap_begin_ > i) {
+      auto entry   = tokens_[--token_gap_begin_];
+      entry.offset = size - entry.offset;
+      tokens_[--token_gap_end_] = entry;
+    }
+    while (token_gap_begin_ < i) {
+      auto entry   = tokens_[token_gap_end_++];
+      entry.offset = size - entry.offset;
+      tokens_[token_gap_begin_++] = entry;
+    }
+  }
+
+  void EditBuffer::insert_token(Token const &tok, std::size_t offset) {
+    if (token_gap_begin_ == token_gap_end_) {
+      auto grow = tokens_.size() + min_gap;
+      tokens_.insert(
+        tokens_.begin() + static_cast<std::ptrdiff_t>(token_gap_end_), grow, Entry{});
+      token_gap_end_ += grow;
+    }
+    tokens_[token_gap_begin_++] = {tok.kind, static_cast<std::uint32_t>(offset),
+      static_cast<std::uint32_t>(tok.repr.size()), tok.symbol, tok.value};
+  }
+
+} // namespace claire::parser
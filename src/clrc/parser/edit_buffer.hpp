@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../source.hpp"
+#include "token.hpp"
+#include "token_buffer.hpp"
+
+namespace claire::parser {
+
+  /// Text of a source being edited, along with its tokens, both updated in place
+  ///
+  /// The text is a gap buffer and the tokens are an array with a gap of their own, both
+  /// gaps moving to each edit. Tokens past the gap store their offset from the end of the
+  /// text rather than from its start, so that an edit leaves them untouched. An edit then
+  /// relexes from the last token ending before it, and stops as soon as a new token
+  /// starts where an old token past the edit did, or at the latest at the first line feed
+  /// past the edit, since a line feed ends every lexeme.
+  ///
+  /// An edit thus costs time in the distance from the previous edit and in the length of
+  /// the edited line, never in the size of the source.
+  class EditBuffer {
+    struct Entry {
+      TokenKind     kind;
+      // From the start of the text ahead of the gap, from its end past the gap
+      std::uint32_t offset;
+      std::uint32_t length;
+      Symbol        symbol;
+      NumeralValue  value;
+    };
+
+    std::string path_;
+
+    std::vector<char> text_;
+    std::size_t       text_gap_begin_;
+    std::size_t       text_gap_end_;
+
+    std::vector<Entry> tokens_;
+    std::size_t        token_gap_begin_;
+    std::size_t        token_gap_end_;
+
+  public:
+    /// Lexes the whole of `source`, which edits then apply to
+    explicit EditBuffer(Source const &source);
+
+    /// Applies `edit` to the text and relexes around it
+    ///
+    /// Malformed lexemes come out as TokenKind::eError tokens, as they do out of the
+    /// lexer. Their diagnostics are reported when lexing a snapshot of the text.
+    ///
+    /// \return number of tokens lexed again
+    std::size_t edit(TextEdit const &edit);
+
+    /// \return size of the text, in bytes
+    [[nodiscard]] std::size_t size() const {
+      return text_.size() - (text_gap_end_ - text_gap_begin_);
+    }
+
+    /// \return number of tokens
+    [[nodiscard]] std::size_t num_tokens() const {
+      return tokens_.size() - (token_gap_end_ - token_gap_begin_);
+    }
+
+    /// \return copy of the whole text, e.g. to build a `Source` from
+    [[nodiscard]] std::string text() const;
+
+    /// \param source source made from `text()`
+    /// \return tokens of `source`, identical to `Lexer{source}.tokenize_buffer()`
+    [[nodiscard]] TokenBuffer tokens(Source const &source) const;
+
+  private:
+    /// \return copy of the text in [begin, end)
+    [[nodiscard]] std::string text(std::size_t begin, std::size_t end) const;
+
+    /// \return byte at `pos` of the text
+    [[nodiscard]] char at(std::size_t pos) const {
+      return pos < text_gap_begin_ ? text_[pos] : text_[pos + text_gap_end_ - text_gap_begin_];
+    }
+
+    /// \return offset of the i-th token from the start of the text
+    [[nodiscard]] std::size_t offset(std::size_t i) const;
+
+    /// \return offset one past the end of the i-th token
+    [[nodiscard]] std::size_t end(std::size_t i) const;
+
+    void replace_text(TextEdit const &edit);
+
+    /// Moves the gap ahead of the i-th token
+    void move_token_gap(std::size_t i);
+
+    void insert_token(Token const &tok, std::size_t offset);
+  };
+
+} // namespace claire::parser
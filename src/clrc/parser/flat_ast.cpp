@@ -0,0 +1,105 @@
+#include "flat_ast.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace claire::parser {
+
+  FlatAST::FlatAST(ASTNode const *root) {
+    if (root) {
+      flatten(root);
+    }
+  }
+
+  void FlatAST::flatten(ASTNode const *root) {
+    struct Frame {
+      ASTNode const *next_child;
+      std::uint32_t  index;
+    };
+
+    // Explicit stack, as the parser does not bound the depth of the tree
+    std::vector<Frame> stack{};
+    // Calls whose callee is yet to be laid out, past the end of the tree
+    std::vector<std::pair<std::uint32_t, Expr const *>> callees{};
+
+    constexpr auto max_depth = std::numeric_limits<std::uint16_t>::max();
+
+    auto visit = [&](ASTNode const *node, std::uint16_t depth) {
+      auto index = emit(node, depth);
+      if (nodes_[index].kind == NodeKind::eFunctionCallExpr) {
+        callees.emplace_back(index, node_cast<FunctionCallExpr>(node)->callee());
+      }
+      stack.push_back({*node->children().begin(), index});
+    };
+
+    visit(root, 0);
+    for (std::size_t pending = 0;; ++pending) {
+      while (not stack.empty()) {
+        auto &frame = stack.back();
+        if (auto const *child = frame.next_child) {
+          frame.next_child = child->next_sibling();
+
+          auto depth = nodes_[frame.index].depth;
+          if (depth == max_depth) {
+            throw std::length_error{"AST nested too deeply to flatten"};
+          }
+          visit(child, static_cast<std::uint16_t>(depth + 1));
+        } else {
+          nodes_[frame.index].end = static_cast<std::uint32_t>(nodes_.size());
+          stack.pop_back();
+        }
+      }
+
+      if (pending == callees.size()) {
+        break;
+      }
+      auto [call, callee]  = callees[pending];
+      nodes_[call].payload = static_cast<std::uint32_t>(nodes_.size());
+      visit(callee, 0);
+    }
+  }
+
+  std::uint32_t FlatAST::emit(ASTNode const *node, std::uint16_t depth) {
+    auto index   = static_cast<std::uint32_t>(nodes_.size());
+    auto payload = std::uint32_t{};
+
+    auto add_decl = [&](std::span<FunctionArg const> args, Symbol return_type,
+                      Symbol linkage_name) {
+      decls_.push_back({static_cast<std::uint32_t>(args_.size()),
+        static_cast<std::uint32_t>(args.size()), return_type, linkage_name});
+      args_.insert(args_.end(), args.begin(), args.end());
+      return static_cast<std::uint32_t>(decls_.size() - 1);
+    };
+
+    switch (node->kind()) {
+    case NodeKind::eFunctionDef: {
+      auto const *def = node_cast<FunctionDef>(node);
+      payload         = add_decl(def->args(), def->return_type(), {});
+      break;
+    }
+    case NodeKind::eExternDecl: {
+      auto const *decl    = node_cast<ExternDecl>(node);
+      auto        literal = decl->linkage_name_literal()->id();
+      payload             = add_decl(decl->args(), decl->return_type(), literal);
+      break;
+    }
+    case NodeKind::eModuleAccessExpr:
+      payload = node_cast<ModuleAccessExpr>(node)->module_name().id();
+      break;
+    case NodeKind::eUnaryExpr:
+      payload = utype(node_cast<UnaryExpr>(node)->op());
+      break;
+    case NodeKind::eBinaryExpr:
+      payload = utype(node_cast<BinaryExpr>(node)->op());
+      break;
+    default:
+      break;
+    }
+
+    nodes_.push_back(
+      {node->kind(), 0, depth, node->id(), node->loc(), index + 1, payload});
+    return index;
+  }
+
+} // namespace claire::parser
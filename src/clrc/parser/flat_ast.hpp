@@ -0,0 +1,290 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "../source_loc.hpp"
+#include "../symbol.hpp"
+#include "ast.hpp"
+
+namespace claire::parser {
+
+  /// Node of a `FlatAST`, 20 bytes with no pointers
+  struct FlatNode {
+    NodeKind      kind;
+    std::uint8_t  reserved;
+    std::uint16_t depth;
+    Symbol        id;
+    SourceLoc     loc;
+    // One past the last node of this subtree, where the next sibling starts if any
+    std::uint32_t end;
+    // Depends on the kind:
+    //   FunctionCallExpr          index of the callee's subtree
+    //   FunctionDef, ExternDecl   index into the declaration side table
+    //   ModuleAccessExpr          symbol id of the module name
+    //   UnaryExpr, BinaryExpr     kind of the operator token
+    std::uint32_t payload;
+  };
+
+  static_assert(sizeof(FlatNode) == 20);
+  static_assert(std::is_trivially_copyable_v<FlatNode>);
+
+  /// Payload of FunctionDef and ExternDecl nodes
+  struct FlatDecl {
+    std::uint32_t args_begin;
+    std::uint32_t args_size;
+    Symbol        return_type;
+    // String literal, quotes included
+    Symbol        linkage_name;
+  };
+
+  /// AST laid out contiguously in pre-order, with 32-bit indices instead of pointers
+  ///
+  /// The tree occupies the first `root().end` nodes, so whole-tree passes are a linear
+  /// scan and the children of a node follow it directly. Subtrees that are not children,
+  /// such as the callee of a call, are stored past the end of the tree. Nodes and side
+  /// tables are trivially copyable, so they serialize as is, as long as symbols are
+  /// interned the same way on both ends.
+  class FlatAST {
+    std::vector<FlatNode>    nodes_;
+    std::vector<FlatDecl>    decls_;
+    std::vector<FunctionArg> args_;
+
+  public:
+    class NodeRef;
+
+    /// Forward range over sibling nodes, hopping from each node to the end of its subtree
+    class Siblings {
+      FlatAST const *ast_;
+      std::uint32_t  begin_;
+      std::uint32_t  end_;
+
+    public:
+      class iterator {
+        FlatAST const *ast_;
+        std::uint32_t  index_;
+
+      public:
+        using value_type      = NodeRef;
+        using difference_type = std::ptrdiff_t;
+
+        iterator(FlatAST const *ast = nullptr, std::uint32_t index = 0)
+          : ast_{ast}
+          , index_{index} {
+        }
+
+        NodeRef operator*() const;
+
+        iterator &operator++() {
+          index_ = ast_->nodes_[index_].end;
+          return *this;
+        }
+
+        iterator operator++(int) {
+          auto prev = *this;
+          ++*this;
+          return prev;
+        }
+
+        bool operator==(iterator const &other) const {
+          return index_ == other.index_;
+        }
+      };
+
+      Siblings(FlatAST const *ast, std::uint32_t begin, std::uint32_t end)
+        : ast_{ast}
+        , begin_{begin}
+        , end_{end} {
+      }
+
+      [[nodiscard]] iterator begin() const {
+        return {ast_, begin_};
+      }
+
+      [[nodiscard]] iterator end() const {
+        return {ast_, end_};
+      }
+
+      [[nodiscard]] bool empty() const {
+        return begin_ == end_;
+      }
+    };
+
+    /// View of a single node, with the same accessors as the node it was flattened from
+    ///
+    /// Accessors are also reachable through `->`, so that code written against node
+    /// pointers reads the same on views.
+    class NodeRef {
+      FlatAST const *ast_;
+      std::uint32_t  index_;
+
+      [[nodiscard]] FlatNode const &node() const {
+        return ast_->nodes_[index_];
+      }
+
+      [[nodiscard]] FlatDecl const &decl() const {
+        return ast_->decls_[node().payload];
+      }
+
+    public:
+      NodeRef(FlatAST const *ast, std::uint32_t index)
+        : ast_{ast}
+        , index_{index} {
+      }
+
+      [[nodiscard]] std::uint32_t index() const {
+        return index_;
+      }
+
+      NodeRef const *operator->() const {
+        return this;
+      }
+
+      [[nodiscard]] NodeKind kind() const {
+        return node().kind;
+      }
+
+      [[nodiscard]] Symbol id() const {
+        return node().id;
+      }
+
+      [[nodiscard]] SourceLoc loc() const {
+        return node().loc;
+      }
+
+      /// \return distance from the root of the tree, or of the detached subtree
+      [[nodiscard]] std::size_t level() const {
+        return node().depth;
+      }
+
+      [[nodiscard]] Siblings children() const {
+        return {ast_, index_ + 1, node().end};
+      }
+
+      /// \pre kind() == NodeKind::eFunctionCallExpr
+      [[nodiscard]] NodeRef callee() const {
+        return {ast_, node().payload};
+      }
+
+      /// \pre kind() is NodeKind::eFunctionDef or NodeKind::eExternDecl
+      [[nodiscard]] std::span<FunctionArg const> args() const {
+        return std::span{ast_->args_}.subspan(decl().args_begin, decl().args_size);
+      }
+
+      /// \pre kind() is NodeKind::eFunctionDef or NodeKind::eExternDecl
+      [[nodiscard]] Symbol return_type() const {
+        return decl().return_type;
+      }
+
+      /// \pre kind() == NodeKind::eExternDecl
+      [[nodiscard]] std::string_view linkage_name() const {
+        auto literal = decl().linkage_name.str();
+        return literal.substr(1, literal.size() - 2);
+      }
+
+      /// \pre kind() == NodeKind::eModuleAccessExpr
+      [[nodiscard]] Symbol module_name() const {
+        return Symbol{node().payload};
+      }
+
+      /// \pre kind() is NodeKind::eUnaryExpr or NodeKind::eBinaryExpr
+      [[nodiscard]] TokenKind op() const {
+        return static_cast<TokenKind>(node().payload);
+      }
+    };
+
+    /// View of a node flattened from a node of type `Node`, which visitors overload on
+    template <typename Node>
+    class Ref : public NodeRef {
+    public:
+      explicit Ref(NodeRef node)
+        : NodeRef{node} {
+      }
+    };
+
+    /// Pre-order iterator over the nodes of the tree
+    class iterator {
+      FlatAST const *ast_;
+      std::uint32_t  index_;
+
+    public:
+      using value_type      = NodeRef;
+      using difference_type = std::ptrdiff_t;
+
+      iterator(FlatAST const *ast = nullptr, std::uint32_t index = 0)
+        : ast_{ast}
+        , index_{index} {
+      }
+
+      NodeRef operator*() const {
+        return {ast_, index_};
+      }
+
+      iterator &operator++() {
+        ++index_;
+        return *this;
+      }
+
+      iterator operator++(int) {
+        auto prev = *this;
+        ++*this;
+        return prev;
+      }
+
+      bool operator==(iterator const &other) const {
+        return index_ == other.index_;
+      }
+    };
+
+    /// Flattens the tree under `root`, which may be deeper than the call stack allows
+    ///
+    /// \throws std::length_error if the tree is more than 65535 levels deep
+    explicit FlatAST(ASTNode const *root);
+
+    [[nodiscard]] NodeRef root() const {
+      return {this, 0};
+    }
+
+    [[nodiscard]] iterator begin() const {
+      return {this, 0};
+    }
+
+    [[nodiscard]] iterator end() const {
+      return {this, nodes_.empty() ? 0 : nodes_.front().end};
+    }
+
+    [[nodiscard]] std::span<FlatNode const> nodes() const {
+      return nodes_;
+    }
+
+    [[nodiscard]] std::span<FlatDecl const> decls() const {
+      return decls_;
+    }
+
+    [[nodiscard]] std::span<FunctionArg const> args() const {
+      return args_;
+    }
+
+  private:
+    /// Appends the subtree under `root`, and the subtrees it refers to
+    void flatten(ASTNode const *root);
+
+    std::uint32_t emit(ASTNode const *node, std::uint16_t depth);
+  };
+
+  inline FlatAST::NodeRef FlatAST::Siblings::iterator::operator*() const {
+    return {ast_, index_};
+  }
+
+  /// Pointer to a node of type `Node`, or view of such a node in a `FlatAST`
+  ///
+  /// Both have the same accessors through `->`, so a visitor overload taking either one
+  /// handles trees and flat ASTs alike.
+  template <typename Ref, typename Node>
+  concept node_ref = std::is_same_v<Ref, Node const *> or
+                     std::is_same_v<Ref, FlatAST::Ref<Node>>;
+
+} // namespace claire::parser
@@ -1,104 +1,299 @@
 #include "lexer.hpp"
 
+#include <atomic>
+#include <cstring>
+
+#include "scan.hpp"
+#include "unicode.hpp"
+
 namespace claire::parser {
 
-  Lexer::Lexer(std::string const &fpath)
+  // Consumes the rest of a run of bytes that would not change the lexical state
+  inline auto skip_run(run_length_fn kernel, char const *&src_ptr, Lexeme &lex) {
+    auto run = kernel(src_ptr);
+    src_ptr += run;
+    lex.len += run;
+    return run;
+  }
+
+  Lexer::Lexer(Source const &source)
+    : Lexer{source, source.data(), source.data() + source.size()} {
+    validate();
+  }
+
+  Lexer::Lexer(Source const &source, char const *begin, char const *end)
     : state_{LexicalState::eNextChar}
-    , source_{loads(fpath)} {
+    , source_{source}
+    , src_ptr_{begin}
+    , lex_{}
+    , end_{end}
+    , diagnostics_{}
+    , stats_{} {
   }
 
-  std::vector<Token> Lexer::tokenize() {
-    Lexeme lex{};
+  void Lexer::validate() {
+    auto size  = static_cast<std::size_t>(end_ - src_ptr_);
+    auto valid = scan.utf8(src_ptr_, size);
+    if (valid != size) {
+      diagnostics_.report(
+        {DiagnosticKind::eInvalidEncoding, source_.loc(offset_of(src_ptr_ + valid)), {}});
+      state_ = LexicalState::eFinal;
+    }
+  }
+
+  Token Lexer::emit(char const *src_ptr) {
+    src_ptr_ = src_ptr;
+    auto tok = lex_.as_token(source_.loc(offset_of(lex_.repr.data())));
+    lex_.reset();
+    stats_.token(tok.kind);
+    return tok;
+  }
+
+  Token Lexer::recover(DiagnosticKind kind, char const *src_ptr, std::size_t width) {
+    auto const *offending = src_ptr - 1;
+    diagnostics_.report({kind, source_.loc(offset_of(offending)), {}});
+
+    // The NUL sentinel is not part of any token, and nothing follows it
+    auto at_eof = *offending == '\0';
+    lex_.kind   = TokenKind::eError;
+    lex_.update_repr(src_ptr, 1, at_eof ? 0 : static_cast<int>(width));
+
+    src_ptr = offending + width;
+    state_  = at_eof or src_ptr == end_ ? LexicalState::eFinal : LexicalState::eNextChar;
+    return emit(at_eof ? offending : src_ptr);
+  }
+
+  std::optional<Token> Lexer::next_token() {
+    auto &lex = lex_;
 
     // Alias pointer to buffer to create register-friendly variable
-    char *src_ptr = source_.data();
+    char const *src_ptr = src_ptr_;
 
-    do {
-      unsigned char ch;
-      auto          eqc = ch_to_eqc[(ch = *src_ptr++)];
+    while (not should_exit(state_)) {
+      auto byte  = static_cast<unsigned char>(*src_ptr++);
+      auto trans = transition(state_, byte);
+      stats_.transition(state_, byte);
 
-      state_ = next_state(state_, eqc);
-      lex.len += lex_inside[utype(state_)];
+      state_ = trans.next();
+      lex.len += trans.inside();
 
       switch (state_) {
       case LexicalState::eNextChar: {
-        ++lex.col_num;
+        auto run = scan.layout(src_ptr);
+        src_ptr += run;
+        stats_.skip(state_, run);
         break;
       }
       case LexicalState::eNewLine: {
-        ++lex.line_num;
-        lex.col_num = 1;
+        // Chunks of a parallel lex end right after a line feed
+        if (src_ptr == end_) {
+          state_ = LexicalState::eFinal;
+        }
         break;
       }
       case LexicalState::eIdentifier: {
         lex.kind = TokenKind::eIdentifier;
+        stats_.skip(state_, skip_run(scan.identifier, src_ptr, lex));
+        break;
+      }
+      case LexicalState::eIdentifierUnicode: {
+        // The lead byte is only counted once the code point is known to belong here
+        auto const *lead = src_ptr - 1;
+        auto        cp   = decode_utf8(lead);
+        lex.len -= 1;
+
+        if (lex.len == 0 ? is_xid_start(cp.value) : is_xid_continue(cp.value)) {
+          src_ptr += cp.size - 1;
+          lex.len += cp.size;
+          lex.kind = TokenKind::eIdentifier;
+          state_   = LexicalState::eIdentifier;
+          stats_.skip(state_, skip_run(scan.identifier, src_ptr, lex));
+          break;
+        }
+        if (lex.len == 0) {
+          return recover(DiagnosticKind::eInvalidLexeme, src_ptr, cp.size);
+        }
+
+        // Code point ends the identifier, and is reevaluated on its own
+        lex.update_repr(src_ptr, 1, 0);
+        lex.to_hyponym();
+        lex.intern();
+        state_ = LexicalState::eIdentifierEnd;
+        return emit(lead);
+      }
+      case LexicalState::eOperatorMulti: {
+        // Multi-character operators without a dedicated kind stay general operators
+        lex.kind = TokenKind::eOperator;
         break;
       }
       case LexicalState::eOperatorMultiEnd:
       case LexicalState::eIdentifierEnd: {
         lex.update_repr(src_ptr, 1, 0);
         lex.to_hyponym();
+        lex.intern();
 
         // End of token requires reevaluation
-        src_ptr += ch_reeval[ch];
-        // TODO(rihtwis-weard): update col pos according to token length if
-        //                    reevaluation occurred
+        src_ptr += trans.reeval();
+        stats_.reevaluate(trans.reeval());
 
-        lex.reset();
-        tokens_.push_back(lex.as_token());
-        break;
+        return emit(src_ptr);
       }
       case LexicalState::eString: {
         lex.kind = TokenKind::eStringLiteral;
+        stats_.skip(state_, skip_run(scan.string, src_ptr, lex));
         break;
       }
       case LexicalState::eStringEnd: {
         lex.update_repr(src_ptr, 1, 1);
-        src_ptr += ch_reeval[ch];
-        lex.reset();
-        tokens_.push_back(lex.as_token());
-        break;
+        src_ptr += trans.reeval();
+        stats_.reevaluate(trans.reeval());
+        return emit(src_ptr);
       }
       case LexicalState::eNumeral: {
         lex.kind = TokenKind::eNumeral;
+        stats_.skip(state_, skip_run(scan.numeral, src_ptr, lex));
         break;
       }
       case LexicalState::eNumeralEnd: {
         lex.update_repr(src_ptr, 1, 0);
-        src_ptr += ch_reeval[ch];
-        lex.reset();
-        tokens_.push_back(lex.as_token());
-        break;
+        if (auto value = decode_numeral(lex.repr)) {
+          lex.value = *value;
+        } else {
+          lex.kind = TokenKind::eError;
+          diagnostics_.report(
+            {DiagnosticKind::eInvalidLexeme, source_.loc(offset_of(lex.repr.data())), {}});
+        }
+
+        src_ptr += trans.reeval();
+        stats_.reevaluate(trans.reeval());
+        return emit(src_ptr);
       }
       case LexicalState::eSeparator: {
-        lex.kind = TokenKind::eSeparator;
         lex.update_repr(src_ptr, 0, 0);
+        lex.to_hyponym(TokenKind::eSeparator);
 
-        lex.reset();
-        tokens_.push_back(lex.as_token());
-        break;
+        return emit(src_ptr);
       }
       case LexicalState::eOperatorSingle: {
         lex.update_repr(src_ptr, 0, 0);
         lex.to_hyponym(TokenKind::eOperator);
 
-        lex.reset();
-        tokens_.push_back(lex.as_token());
-        break;
+        return emit(src_ptr);
       }
       case LexicalState::eEOF: {
-        throw unexpected_eof{};
+        return recover(DiagnosticKind::eUnexpectedEOF, src_ptr);
       }
       case LexicalState::eError: {
-        throw invalid_lexeme{};
+        return recover(DiagnosticKind::eInvalidLexeme, src_ptr);
       }
       default:
         break;
       }
+    }
+
+    src_ptr_ = src_ptr;
+    return std::nullopt;
+  }
+
+  std::vector<Token> Lexer::tokenize(Diagnostics &diagnostics) {
+    while (auto tok = next_token()) {
+      tokens_.push_back(*tok);
+    }
+    diagnostics.append(std::move(diagnostics_));
+
+    // Tokens are views into `source_`, hand them over without copying
+    return std::move(tokens_);
+  }
+
+  std::vector<Token> Lexer::tokenize() {
+    auto diagnostics = Diagnostics{};
+    auto tokens      = tokenize(diagnostics);
+    diagnostics.raise_first();
+    return tokens;
+  }
+
+  TokenBuffer Lexer::tokenize_buffer(Diagnostics &diagnostics) {
+    auto buffer = TokenBuffer{source_.data(), source_.loc(0)};
+    while (auto tok = next_token()) {
+      buffer.push_back(*tok);
+    }
+    diagnostics.append(std::move(diagnostics_));
+    return buffer;
+  }
+
+  TokenBuffer Lexer::tokenize_buffer() {
+    auto diagnostics = Diagnostics{};
+    auto buffer      = tokenize_buffer(diagnostics);
+    diagnostics.raise_first();
+    return buffer;
+  }
+
+  std::vector<Token> Lexer::tokenize_parallel(
+    Diagnostics &diagnostics, std::size_t num_threads, std::size_t chunk_size) {
+    auto const *begin = src_ptr_;
+    auto const *end   = end_;
+
+    // Chunk boundaries, each one right past a line feed
+    std::vector<char const *> bounds{begin};
+    for (auto const *ptr = begin; end - ptr > static_cast<std::ptrdiff_t>(chunk_size);) {
+      auto const *lf = static_cast<char const *>(std::memchr(
+        ptr + chunk_size, '\n', static_cast<std::size_t>(end - ptr) - chunk_size));
+      if (not lf) {
+        break;
+      }
+      ptr = lf + 1;
+      bounds.push_back(ptr);
+    }
+    bounds.push_back(end);
 
-    } while (not should_exit(state_));
+    // Chunks need no validation of their own, unless there is nothing to lex at all
+    auto num_chunks = bounds.size() - 1;
+    if (num_chunks == 1 or num_threads <= 1 or should_exit(state_)) {
+      return tokenize(diagnostics);
+    }
+
+    std::vector<std::vector<Token>> chunk_tokens(num_chunks);
+    std::vector<Diagnostics>        chunk_diagnostics(num_chunks);
+    std::atomic<std::size_t>        next_chunk{0};
+
+    auto worker = [&]() {
+      for (std::size_t i; (i = next_chunk.fetch_add(1)) < num_chunks;) {
+        chunk_tokens[i] =
+          Lexer{source_, bounds[i], bounds[i + 1]}.tokenize(chunk_diagnostics[i]);
+      }
+    };
+
+    {
+      std::vector<std::jthread> pool{};
+      for (std::size_t t = 1; t < std::min(num_threads, num_chunks); ++t) {
+        pool.emplace_back(worker);
+      }
+      worker();
+    }
+
+    // Diagnostics in source order, as the serial lexer would have reported them
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < num_chunks; ++i) {
+      diagnostics.append(std::move(chunk_diagnostics[i]));
+      total += chunk_tokens[i].size();
+    }
+
+    tokens_.reserve(total);
+    for (auto const &chunk : chunk_tokens) {
+      tokens_.insert(tokens_.end(), chunk.begin(), chunk.end());
+    }
+
+    src_ptr_ = end;
+    state_   = LexicalState::eFinal;
+    return std::move(tokens_);
+  }
 
-    return tokens_;
+  std::vector<Token> Lexer::tokenize_parallel(
+    std::size_t num_threads, std::size_t chunk_size) {
+    auto diagnostics = Diagnostics{};
+    auto tokens      = tokenize_parallel(diagnostics, num_threads, chunk_size);
+    diagnostics.raise_first();
+    return tokens;
   }
 
 } // namespace claire::parser
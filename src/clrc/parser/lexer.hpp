@@ -1,22 +1,113 @@
 #pragma once
 
+#include <optional>
+#include <thread>
 #include <vector>
 
-#include "../exception.hpp"
-#include "state_machine.h"
-#include "token.h"
+#include "../diagnostics.hpp"
+#include "../source.hpp"
+#include "lexer_stats.hpp"
+#include "state_machine.hpp"
+#include "token.hpp"
+#include "token_buffer.hpp"
 
 namespace claire::parser {
 
   class Lexer {
     LexicalState       state_;
-    std::string        source_;
+    Source const      &source_;
     std::vector<Token> tokens_;
 
+    // Resumption point for `next_token`
+    char const *src_ptr_;
+    Lexeme      lex_;
+
+    // Lexing stops at the first line feed ending here
+    char const *end_;
+
+    // Errors found by `next_token` so far
+    Diagnostics diagnostics_;
+
+    [[no_unique_address]] LexerStats stats_;
+
   public:
-    explicit Lexer(std::string const &fpath);
+    static constexpr std::size_t default_chunk_size = std::size_t{1} << 20;
+
+    /// Source text must be valid UTF-8, which is checked up front. Otherwise a single
+    /// diagnostic points at the first invalid byte and no tokens are produced.
+    explicit Lexer(Source const &source);
+
+    // Tokens are views into the source, which must outlive the lexer
+    Lexer(Source &&) = delete;
+
+    /// Lexes up to and including the next token, resuming wherever the previous call
+    /// left off
+    ///
+    /// Malformed lexemes do not stop lexing. They come out as TokenKind::eError tokens,
+    /// each along with a diagnostic, and lexing resumes right after them.
+    ///
+    /// \return the next token, or std::nullopt once the source is exhausted
+    /// \throws std::bad_alloc when out of memory for diagnostics or interned symbols
+    std::optional<Token> next_token();
+
+    /// Errors found by `next_token` so far
+    [[nodiscard]] Diagnostics const &diagnostics() const {
+      return diagnostics_;
+    }
+
+    /// Lexes the remainder of the source in one go
+    ///
+    /// \param diagnostics sink for every error found, which become TokenKind::eError
+    ///                    tokens
+    std::vector<Token> tokenize(Diagnostics &diagnostics);
 
+    /// Lexes the remainder of the source in one go
+    ///
+    /// \throws unexpected_eof, invalid_lexeme, invalid_encoding for the first error found
     std::vector<Token> tokenize();
+
+    /// Lexes the remainder of the source in one go, into struct-of-arrays storage
+    TokenBuffer tokenize_buffer(Diagnostics &diagnostics);
+
+    /// \throws unexpected_eof, invalid_lexeme, invalid_encoding for the first error found
+    TokenBuffer tokenize_buffer();
+
+    /// Lexes the remainder of the source in chunks on a pool of threads
+    ///
+    /// Chunks are split right after line feeds. A line feed always ends the current
+    /// lexeme (string literals cannot span lines), so every chunk starts from the same
+    /// state the serial lexer would be in and the result is identical to `tokenize()`,
+    /// diagnostics included.
+    ///
+    /// \param diagnostics sink for every error found, in source order
+    /// \param num_threads upper bound on the number of threads used
+    /// \param chunk_size approximate number of bytes per chunk
+    std::vector<Token> tokenize_parallel(Diagnostics &diagnostics,
+      std::size_t num_threads = std::thread::hardware_concurrency(),
+      std::size_t chunk_size  = default_chunk_size);
+
+    /// \throws unexpected_eof, invalid_lexeme, invalid_encoding for the first error found
+    std::vector<Token> tokenize_parallel(
+      std::size_t num_threads = std::thread::hardware_concurrency(),
+      std::size_t chunk_size  = default_chunk_size);
+
+  private:
+    Lexer(Source const &source, char const *begin, char const *end);
+
+    /// Checks that the text left to lex is valid UTF-8, and finishes lexing if it is not
+    void validate();
+
+    Token emit(char const *src_ptr);
+
+    /// Reports the byte before `src_ptr` as an error and turns the lexeme so far into an
+    /// error token, after which lexing resumes from a clean state
+    ///
+    /// \param width number of bytes of the offending character
+    Token recover(DiagnosticKind kind, char const *src_ptr, std::size_t width = 1);
+
+    [[nodiscard]] std::size_t offset_of(char const *src_ptr) const {
+      return static_cast<std::size_t>(src_ptr - source_.data());
+    }
   };
 
 } // namespace claire::parser
@@ -0,0 +1,291 @@
+#include "lexer_stats.hpp"
+
+#ifdef CLAIRE_LEXER_STATS
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace claire::parser {
+
+  namespace {
+
+    constexpr std::string_view state_names[] = {
+      "Final",
+      "NextChar",
+      "Separator",
+      "OperatorSingle",
+      "OperatorMulti",
+      "OperatorMultiEnd",
+      "Identifier",
+      "IdentifierEnd",
+      "IdentifierUnicode",
+      "Numeral",
+      "NumeralExponent",
+      "NumeralEnd",
+      "String",
+      "StringEnd",
+      "Comment",
+      "NewLine",
+      "EOF",
+      "Error",
+    };
+
+    constexpr std::string_view glyph_names[] = {
+      "Layout",
+      "Space",
+      "CarriageReturn",
+      "LineFeed",
+      "Letter",
+      "Digit",
+      "Separator",
+      "Operator",
+      "Colon",
+      "Hyphen",
+      "VerticalBar",
+      "DoubleQuote",
+      "Unicode",
+      "EOF",
+    };
+
+    constexpr std::string_view token_kind_names[] = {
+      "Identifier",
+      "StringLiteral",
+      "Numeral",
+      "Separator",
+      "Operator",
+      "AccessMember",
+      "LParens",
+      "RParens",
+      "Minus",
+      "Plus",
+      "Less",
+      "Greater",
+      "Assign",
+      "Colon",
+      "ScopeBegin",
+      "ScopeEnd",
+      "Semicolon",
+      "Backslash",
+      "AccessNamespace",
+      "Arrow",
+      "Pipe",
+      "ReservedFunc",
+      "ReservedLet",
+      "ReservedIf",
+      "ReservedElse",
+      "ReservedOpen",
+      "ReservedModule",
+      "ReservedExport",
+      "ReservedExtern",
+      "ReservedWhen",
+      "TypeBinary",
+      "TypeU32",
+      "Error",
+      "EndOfInput",
+    };
+
+    static_assert(std::size(state_names) == utype(LexicalState::eCount));
+    static_assert(std::size(glyph_names) == utype(Glyph::eCount));
+    static_assert(std::size(token_kind_names) == utype(TokenKind::eCount));
+
+    constexpr auto num_states = utype(LexicalState::eCount);
+    constexpr auto num_glyphs = utype(Glyph::eCount);
+
+    struct ClassCount {
+      std::size_t   state;
+      std::size_t   glyph;
+      std::uint64_t count;
+    };
+
+    // Transitions folded from source bytes into their equivalence classes
+    std::vector<ClassCount> class_counts(LexerCounters const &counters) {
+      std::vector<ClassCount> counts{};
+      for (std::size_t s = 0; s < num_states; ++s) {
+        std::array<std::uint64_t, num_glyphs> by_glyph{};
+        for (std::size_t ch = 0; ch < 256; ++ch) {
+          by_glyph[utype(glyph_of(static_cast<unsigned char>(ch)))] +=
+            counters.transitions[s][ch];
+        }
+        for (std::size_t g = 0; g < num_glyphs; ++g) {
+          if (by_glyph[g] != 0) {
+            counts.push_back({s, g, by_glyph[g]});
+          }
+        }
+      }
+      return counts;
+    }
+
+    std::array<std::uint64_t, 256> byte_counts(LexerCounters const &counters) {
+      std::array<std::uint64_t, 256> counts{};
+      for (auto const &row : counters.transitions) {
+        for (std::size_t ch = 0; ch < 256; ++ch) {
+          counts[ch] += row[ch];
+        }
+      }
+      return counts;
+    }
+
+    double percent(std::uint64_t part, std::uint64_t total) {
+      return total == 0 ? 0.0 : 100.0 * static_cast<double>(part) / static_cast<double>(total);
+    }
+
+    // Counters of every lexer destroyed so far, dumped once the program exits
+    struct Totals {
+      std::mutex    mutex;
+      LexerCounters counters{};
+
+      ~Totals() {
+        if (auto const *path = std::getenv("CLAIRE_LEXER_STATS"); path and *path) {
+          auto os = std::ofstream{path};
+          counters.write_json(os);
+        } else {
+          counters.write_report(std::cerr);
+        }
+      }
+    };
+
+    Totals &totals() {
+      static Totals totals{};
+      return totals;
+    }
+
+  } // namespace
+
+  LexerCounters &LexerCounters::operator+=(LexerCounters const &other) {
+    for (std::size_t s = 0; s < num_states; ++s) {
+      for (std::size_t ch = 0; ch < 256; ++ch) {
+        transitions[s][ch] += other.transitions[s][ch];
+      }
+      skipped[s] += other.skipped[s];
+    }
+    reevaluations += other.reevaluations;
+    for (std::size_t k = 0; k < tokens.size(); ++k) {
+      tokens[k] += other.tokens[k];
+    }
+    return *this;
+  }
+
+  void LexerCounters::write_json(std::ostream &os) const {
+    os << "{\n  \"transitions\": [";
+    auto sep = "\n";
+    for (auto const &[state, glyph, count] : class_counts(*this)) {
+      os << sep << "    {\"state\": \"" << state_names[state] << "\", \"class\": \""
+         << glyph_names[glyph] << "\", \"count\": " << count << "}";
+      sep = ",\n";
+    }
+
+    os << "\n  ],\n  \"bytes\": {";
+    sep        = "";
+    auto bytes = byte_counts(*this);
+    for (std::size_t ch = 0; ch < 256; ++ch) {
+      if (bytes[ch] != 0) {
+        os << sep << "\"" << ch << "\": " << bytes[ch];
+        sep = ", ";
+      }
+    }
+
+    os << "},\n  \"skipped\": {";
+    sep = "";
+    for (std::size_t s = 0; s < num_states; ++s) {
+      if (skipped[s] != 0) {
+        os << sep << "\"" << state_names[s] << "\": " << skipped[s];
+        sep = ", ";
+      }
+    }
+
+    os << "},\n  \"reevaluations\": " << reevaluations << ",\n  \"tokens\": {";
+    sep = "";
+    for (std::size_t k = 0; k < tokens.size(); ++k) {
+      if (tokens[k] != 0) {
+        os << sep << "\"" << token_kind_names[k] << "\": " << tokens[k];
+        sep = ", ";
+      }
+    }
+    os << "}\n}\n";
+  }
+
+  void LexerCounters::write_report(std::ostream &os) const {
+    constexpr std::size_t top = 16;
+
+    auto classes = class_counts(*this);
+    std::sort(classes.begin(), classes.end(),
+      [](auto const &lhs, auto const &rhs) { return lhs.count > rhs.count; });
+
+    std::uint64_t num_transitions = 0;
+    for (auto const &entry : classes) {
+      num_transitions += entry.count;
+    }
+
+    std::uint64_t num_skipped = 0;
+    for (auto count : skipped) {
+      num_skipped += count;
+    }
+
+    std::uint64_t num_tokens = 0;
+    for (auto count : tokens) {
+      num_tokens += count;
+    }
+
+    os << std::fixed << std::setprecision(1);
+    os << "lexer: " << num_transitions << " DFA transitions, " << num_skipped
+       << " bytes skipped by scan kernels, " << num_tokens << " tokens, " << reevaluations
+       << " reevaluations\n";
+
+    os << "\ntransitions by state and class\n";
+    for (std::size_t i = 0; i < std::min(top, classes.size()); ++i) {
+      auto const &[state, glyph, count] = classes[i];
+      os << "  " << std::left << std::setw(18) << state_names[state] << std::setw(16)
+         << glyph_names[glyph] << std::right << std::setw(14) << count << std::setw(7)
+         << percent(count, num_transitions) << "%\n";
+    }
+
+    auto bytes = byte_counts(*this);
+    std::vector<std::size_t> hot(256);
+    for (std::size_t ch = 0; ch < 256; ++ch) {
+      hot[ch] = ch;
+    }
+    std::sort(hot.begin(), hot.end(),
+      [&](auto lhs, auto rhs) { return bytes[lhs] > bytes[rhs]; });
+
+    os << "\nhot bytes\n";
+    for (std::size_t i = 0; i < top and bytes[hot[i]] != 0; ++i) {
+      auto ch = hot[i];
+      os << "  0x" << std::hex << std::setw(2) << std::setfill('0') << ch << std::dec
+         << std::setfill(' ') << " " << (ch >= 0x21 and ch < 0x7f ? static_cast<char>(ch) : ' ')
+         << std::setw(14) << bytes[ch] << std::setw(7) << percent(bytes[ch], num_transitions)
+         << "%\n";
+    }
+
+    os << "\nskipped bytes by state\n";
+    for (std::size_t s = 0; s < num_states; ++s) {
+      if (skipped[s] != 0) {
+        os << "  " << std::left << std::setw(18) << state_names[s] << std::right
+           << std::setw(14) << skipped[s] << "\n";
+      }
+    }
+
+    os << "\ntokens by kind\n";
+    for (std::size_t k = 0; k < tokens.size(); ++k) {
+      if (tokens[k] != 0) {
+        os << "  " << std::left << std::setw(18) << token_kind_names[k] << std::right
+           << std::setw(14) << tokens[k] << std::setw(7) << percent(tokens[k], num_tokens)
+           << "%\n";
+      }
+    }
+  }
+
+  LexerStats::~LexerStats() {
+    auto &all  = totals();
+    auto  lock = std::lock_guard{all.mutex};
+    all.counters += counters_;
+  }
+
+} // namespace claire::parser
+
+#endif
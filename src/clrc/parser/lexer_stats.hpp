@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+#include "state_machine.hpp"
+#include "token.hpp"
+
+namespace claire::parser {
+
+#ifdef CLAIRE_LEXER_STATS
+
+  struct LexerCounters {
+    // Transitions taken by the DFA, by state before the transition and source byte
+    std::array<std::array<std::uint64_t, 256>, utype(LexicalState::eCount)> transitions;
+    // Bytes skipped over by scan kernels without going through the DFA, by state
+    std::array<std::uint64_t, utype(LexicalState::eCount)> skipped;
+    // Bytes lexed again after ending a token
+    std::uint64_t                                          reevaluations;
+    std::array<std::uint64_t, utype(TokenKind::eCount)>    tokens;
+
+    LexerCounters &operator+=(LexerCounters const &other);
+
+    void write_json(std::ostream &os) const;
+    void write_report(std::ostream &os) const;
+  };
+
+  /// Instrumentation of the lexer DFA, only compiled in with CLAIRE_LEXER_STATS
+  ///
+  /// Each lexer counts into its own instance, which is merged into process-wide totals
+  /// when the lexer is destroyed, so that lexing in parallel does not contend on the
+  /// counters. The totals are dumped at exit, as JSON to the path named by the
+  /// CLAIRE_LEXER_STATS environment variable, or as a report to stderr otherwise.
+  class LexerStats {
+    LexerCounters counters_{};
+
+  public:
+    LexerStats() = default;
+
+    LexerStats(LexerStats const &)            = delete;
+    LexerStats &operator=(LexerStats const &) = delete;
+
+    ~LexerStats();
+
+    void transition(LexicalState from, unsigned char ch) {
+      ++counters_.transitions[utype(from)][ch];
+    }
+
+    void skip(LexicalState state, std::size_t run) {
+      counters_.skipped[utype(state)] += run;
+    }
+
+    void reevaluate(std::ptrdiff_t reeval) {
+      counters_.reevaluations += reeval != 0;
+    }
+
+    void token(TokenKind kind) {
+      ++counters_.tokens[utype(kind)];
+    }
+  };
+
+#else
+
+  // Compiles to nothing without CLAIRE_LEXER_STATS
+  class LexerStats {
+  public:
+    void transition(LexicalState, unsigned char) {
+    }
+
+    void skip(LexicalState, std::size_t) {
+    }
+
+    void reevaluate(std::ptrdiff_t) {
+    }
+
+    void token(TokenKind) {
+    }
+  };
+
+#endif
+
+} // namespace claire::parser
@@ -0,0 +1,69 @@
+#include "module_cache.hpp"
+
+namespace claire::parser {
+
+  ModuleKey module_key(std::string path, Source const &source) {
+    auto text = source.text();
+    return {std::move(path), robin_hood::hash_bytes(text.data(), text.size())};
+  }
+
+  std::size_t ModuleCache::KeyHash::operator()(ModuleKey const &key) const {
+    return robin_hood::hash_bytes(key.path.data(), key.path.size()) ^ key.hash;
+  }
+
+  Module const &ModuleCache::get(
+    ModuleKey const &key, std::function<void(Module &)> const &parse) {
+    auto entry = std::shared_ptr<Entry>{};
+    {
+      auto  lock = std::unique_lock{mutex_};
+      auto &slot = entries_[key];
+      if (slot) {
+        // Held on to, as a failed parse drops it from the cache
+        entry = slot;
+        ready_.wait(lock, [&]() { return entry->ready; });
+        if (entry->error) {
+          std::rethrow_exception(entry->error);
+        }
+        return entry->module;
+      }
+      entry = slot = std::make_shared<Entry>();
+    }
+
+    // Without holding the lock, so that other modules can be requested meanwhile
+    try {
+      parse(entry->module);
+    } catch (...) {
+      // Only for the requests made so far, the next one parses again
+      {
+        auto lock    = std::unique_lock{mutex_};
+        entry->ready = true;
+        entry->error = std::current_exception();
+        entries_.erase(key);
+      }
+      ready_.notify_all();
+      throw;
+    }
+
+    {
+      auto lock    = std::unique_lock{mutex_};
+      entry->ready = true;
+    }
+    ready_.notify_all();
+    return entry->module;
+  }
+
+  Module const *ModuleCache::find(ModuleKey const &key) const {
+    auto lock = std::unique_lock{mutex_};
+    auto it   = entries_.find(key);
+    if (it != entries_.end() and it->second->ready) {
+      return &it->second->module;
+    }
+    return nullptr;
+  }
+
+  std::size_t ModuleCache::size() const {
+    auto lock = std::unique_lock{mutex_};
+    return entries_.size();
+  }
+
+} // namespace claire::parser
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <robin_hood.h>
+
+#include "../diagnostics.hpp"
+#include "../source.hpp"
+#include "../symbol.hpp"
+#include "ast.hpp"
+
+namespace claire::parser {
+
+  /// `open` of a module declared in another source
+  struct Import {
+    Symbol    module;
+    SourceLoc loc;
+  };
+
+  /// Module parsed from a source of its own
+  struct Module {
+    Symbol                        name{};
+    // Canonical path of the source the module was parsed from
+    std::string                   path{};
+    // Owned along with the tree, so that tokens and diagnostics can point into it
+    std::unique_ptr<Source const> source{};
+    // Rooted at a ModuleDecl named after the module
+    AST                           ast{};
+    // Errors found in the source of the module
+    Diagnostics                   diagnostics{};
+    std::vector<Import>           imports{};
+
+    [[nodiscard]] ModuleDecl const *root() const {
+      return ast.root() ? node_cast<ModuleDecl>(ast.root()) : nullptr;
+    }
+  };
+
+  /// Identity of a parsed module, which changes along with the text of its source
+  struct ModuleKey {
+    std::string   path;
+    std::uint64_t hash;
+
+    friend bool operator==(ModuleKey const &lhs, ModuleKey const &rhs) = default;
+  };
+
+  /// \param path canonical path of `source`
+  ModuleKey module_key(std::string path, Source const &source);
+
+  class ModuleInterfaceCache;
+
+  /// Modules parsed in this process, each parsed once per version of its source and
+  /// shared by every build and every source that opens it
+  ///
+  /// Modules are never evicted nor moved, so references to them stay valid for the
+  /// lifetime of the cache. A source edited since it was parsed hashes to a new key, and
+  /// is parsed again into a new entry. A parse that throws leaves no entry behind, so
+  /// that the next request for its key parses it again.
+  ///
+  /// It may be backed by precompiled interfaces, which modules are then built from rather
+  /// than parsed, and which modules parsed without errors are written to.
+  class ModuleCache {
+    struct KeyHash {
+      std::size_t operator()(ModuleKey const &key) const;
+    };
+
+    struct Entry {
+      bool               ready{};
+      Module             module{};
+      // Thrown by the request parsing the module, to the requests waiting on it
+      std::exception_ptr error{};
+    };
+
+    mutable std::mutex                                                    mutex_;
+    std::condition_variable                                               ready_;
+    // Shared with the requests waiting on an entry, which outlives its failed parse
+    robin_hood::unordered_map<ModuleKey, std::shared_ptr<Entry>, KeyHash> entries_;
+    ModuleInterfaceCache const                                          *interfaces_;
+
+  public:
+    /// \param interfaces outlives the cache, if any
+    explicit ModuleCache(ModuleInterfaceCache const *interfaces = nullptr)
+      : interfaces_{interfaces} {
+    }
+
+    /// \return precompiled interfaces backing the cache, nullptr if there are none
+    [[nodiscard]] ModuleInterfaceCache const *interfaces() const {
+      return interfaces_;
+    }
+
+    /// Requests for a key being parsed block until it is. `parse` must thus never wait
+    /// itself, on other modules or otherwise, so that a request blocked here, on a thread
+    /// pool or not, always waits on a parse that makes progress.
+    ///
+    /// \param parse fills in the module on the first request for `key`
+    /// \return the module cached under `key`, once the first request has parsed it
+    /// \throws whatever `parse` threw, to the request that called it and to those waiting
+    ///         on it, after which `key` is parsed again on the next request
+    Module const &get(ModuleKey const &key, std::function<void(Module &)> const &parse);
+
+    /// \return the module cached under `key`, nullptr if it is not parsed yet
+    [[nodiscard]] Module const *find(ModuleKey const &key) const;
+
+    /// \return the number of modules parsed or being parsed
+    [[nodiscard]] std::size_t size() const;
+  };
+
+} // namespace claire::parser
@@ -0,0 +1,372 @@
+#include "module_interface.hpp"
+
+#include <array>
+#include <cerrno>
+#include <fcntl.h>
+#include <functional>
+#include <iomanip>
+#include <span>
+#include <sstream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+
+#include <robin_hood.h>
+
+namespace claire::parser {
+
+  namespace {
+
+    // Layout of a `.clrm` file, in the byte order of the host:
+    //
+    //   Header | ImportRecord... | DeclRecord... | ArgRecord... | strings
+    //
+    // Every record is made of 32-bit fields, so that they are all aligned within the
+    // mapping. Strings are referred to by offset into the trailing string table.
+
+    constexpr std::array<char, 4> magic = {'C', 'L', 'R', 'M'};
+
+    // Bumped whenever the records change
+    constexpr std::uint32_t format_version = 2;
+
+    // Offset of a location that is unknown
+    constexpr std::uint32_t no_offset = ~std::uint32_t{0};
+
+    struct StringRef {
+      std::uint32_t offset;
+      std::uint32_t size;
+    };
+
+    struct Header {
+      std::array<char, 4> magic;
+      std::uint32_t       format;
+      std::uint64_t       compiler;
+      std::uint64_t       source;
+      std::uint32_t       num_imports;
+      std::uint32_t       num_decls;
+      std::uint32_t       num_args;
+      std::uint32_t       strings_size;
+    };
+
+    struct ImportRecord {
+      StringRef     module;
+      std::uint32_t offset;
+    };
+
+    // Kind of a declaration on disk, kept apart from NodeKind so that adding node kinds
+    // leaves the format unchanged. Values are never reused.
+    enum class DeclTag : std::uint32_t {
+      eOpen   = 1,
+      eExtern = 2,
+    };
+
+    // Declaration at the root of the module, either an `open` or an `extern`
+    struct DeclRecord {
+      DeclTag       tag;
+      std::uint32_t offset;
+      StringRef     id;
+      StringRef     return_type;
+      StringRef     linkage_name;
+      std::uint32_t linkage_offset;
+      std::uint32_t first_arg;
+      std::uint32_t num_args;
+    };
+
+    struct ArgRecord {
+      StringRef name;
+      StringRef type;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Header> and alignof(Header) == 8 and
+                  sizeof(Header) % 8 == 0);
+    static_assert(alignof(ImportRecord) == 4 and alignof(DeclRecord) == 4 and
+                  alignof(ArgRecord) == 4);
+
+    std::uint64_t compiler_hash() {
+      constexpr std::string_view version = CLAIRE_VERSION;
+      return robin_hood::hash_bytes(version.data(), version.size());
+    }
+
+    /// Read-only mapping of a whole file, empty if it cannot be mapped
+    class MappedFile {
+      void       *data_{};
+      std::size_t size_{};
+
+    public:
+      explicit MappedFile(std::filesystem::path const &path) {
+        auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+          return;
+        }
+
+        struct stat st {};
+        if (::fstat(fd, &st) == 0 and S_ISREG(st.st_mode) and st.st_size > 0) {
+          auto size = static_cast<std::size_t>(st.st_size);
+          auto data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+          if (data != MAP_FAILED) {
+            data_ = data;
+            size_ = size;
+          }
+        }
+        ::close(fd);
+      }
+
+      MappedFile(MappedFile const &)            = delete;
+      MappedFile &operator=(MappedFile const &) = delete;
+
+      ~MappedFile() {
+        if (data_) {
+          ::munmap(data_, size_);
+        }
+      }
+
+      [[nodiscard]] std::byte const *data() const {
+        return static_cast<std::byte const *>(data_);
+      }
+
+      [[nodiscard]] std::size_t size() const {
+        return size_;
+      }
+    };
+
+    /// \return the next `count` records at `cursor`, which is moved past them
+    template <typename T>
+    std::span<T const> records(std::byte const *&cursor, std::size_t count) {
+      auto const *first = reinterpret_cast<T const *>(cursor);
+      cursor += count * sizeof(T);
+      return {first, count};
+    }
+
+    template <typename T>
+    void append(std::string &bytes, std::span<T const> items) {
+      bytes.append(reinterpret_cast<char const *>(items.data()), items.size_bytes());
+    }
+
+    /// Writes `bytes` to a file of its own, then renames it to `path`
+    ///
+    /// A rename replaces the previous file at once, so readers see either version but
+    /// never a partial one. The data is not synced: a file truncated by a crash fails
+    /// validation on load, and is simply written again.
+    bool write_atomically(std::filesystem::path const &path, std::string_view bytes) {
+      // Unique to this thread, so that concurrent writers never share a temporary file
+      auto tmp = path;
+      tmp += "." + std::to_string(::getpid()) + "." +
+             std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) +
+             ".tmp";
+
+      auto fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+      if (fd < 0) {
+        return false;
+      }
+
+      auto ok = true;
+      for (auto const *data = bytes.data(), *end = data + bytes.size(); data < end;) {
+        auto n = ::write(fd, data, static_cast<std::size_t>(end - data));
+        if (n < 0) {
+          if (errno == EINTR) {
+            continue;
+          }
+          ok = false;
+          break;
+        }
+        data += n;
+      }
+
+      ok = ::close(fd) == 0 and ok;
+      if (not ok or ::rename(tmp.c_str(), path.c_str()) != 0) {
+        ::unlink(tmp.c_str());
+        return false;
+      }
+      return true;
+    }
+
+  } // namespace
+
+  ModuleInterfaceCache::ModuleInterfaceCache(std::filesystem::path dir)
+    : dir_{std::move(dir)} {
+  }
+
+  bool ModuleInterfaceCache::load(
+    ModuleKey const &key, Source const &source, Module &module) const {
+    auto file = MappedFile{path(key)};
+    if (file.size() < sizeof(Header)) {
+      return false;
+    }
+
+    // Mappings are page aligned, and so are the records within them
+    auto const &header = *reinterpret_cast<Header const *>(file.data());
+    if (header.magic != magic or header.format != format_version or
+        header.compiler != compiler_hash() or header.source != key.hash) {
+      return false;
+    }
+
+    auto expected_size = sizeof(Header) + header.num_imports * sizeof(ImportRecord) +
+                         header.num_decls * sizeof(DeclRecord) +
+                         header.num_args * sizeof(ArgRecord) + header.strings_size;
+    if (file.size() != expected_size) {
+      return false;
+    }
+
+    auto const *cursor  = file.data() + sizeof(Header);
+    auto        imports = records<ImportRecord>(cursor, header.num_imports);
+    auto        decls   = records<DeclRecord>(cursor, header.num_decls);
+    auto        args    = records<ArgRecord>(cursor, header.num_args);
+    auto        strings =
+      std::string_view{reinterpret_cast<char const *>(cursor), header.strings_size};
+
+    // Anything out of bounds means the file is not an interface after all
+    auto valid = true;
+    auto str   = [&](StringRef ref) {
+      if (ref.offset > strings.size() or ref.size > strings.size() - ref.offset) {
+        valid = false;
+        return Symbol{};
+      }
+      return intern(strings.substr(ref.offset, ref.size));
+    };
+    auto loc = [&](std::uint32_t offset) {
+      if (offset == no_offset) {
+        return SourceLoc{};
+      }
+      valid = valid and offset <= source.size();
+      return valid ? source.loc(offset) : SourceLoc{};
+    };
+
+    auto  ast  = AST{};
+    auto *root = ast.make<ModuleDecl>(module.name);
+    root->set_loc(source.loc(0));
+
+    std::vector<FunctionArg> decl_args{};
+    for (auto const &decl : decls) {
+      ASTNode *node{};
+      switch (decl.tag) {
+      case DeclTag::eOpen:
+        node = ast.make<OpenDecl>(str(decl.id));
+        break;
+      case DeclTag::eExtern: {
+        if (decl.first_arg > args.size() or
+            decl.num_args > args.size() - decl.first_arg) {
+          return false;
+        }
+        decl_args.clear();
+        for (auto const &arg : args.subspan(decl.first_arg, decl.num_args)) {
+          decl_args.push_back({str(arg.name), str(arg.type)});
+        }
+
+        auto *linkage_name = ast.make<StringExpr>(str(decl.linkage_name));
+        linkage_name->set_loc(loc(decl.linkage_offset));
+        auto copy = ast.arena().copy(std::span<FunctionArg const>{decl_args});
+        node =
+          ast.make<ExternDecl>(str(decl.id), copy, str(decl.return_type), linkage_name);
+        break;
+      }
+      default:
+        return false;
+      }
+      node->set_loc(loc(decl.offset));
+      root->add(node);
+    }
+
+    std::vector<Import> module_imports{};
+    for (auto const &import : imports) {
+      module_imports.push_back({str(import.module), loc(import.offset)});
+    }
+
+    if (not valid) {
+      return false;
+    }
+    ast.set_root(root);
+    module.ast     = std::move(ast);
+    module.imports = std::move(module_imports);
+    return true;
+  }
+
+  bool ModuleInterfaceCache::store(
+    ModuleKey const &key, Source const &source, Module const &module) const {
+    // Diagnostics are only reported by parsing, so modules with errors are never cached
+    if (not module.root() or not module.diagnostics.empty()) {
+      return false;
+    }
+
+    std::vector<ImportRecord> imports{};
+    std::vector<DeclRecord>   decls{};
+    std::vector<ArgRecord>    args{};
+    std::string               strings{};
+
+    auto str = [&](Symbol sym) {
+      auto spelling = sym.str();
+      auto ref      = StringRef{static_cast<std::uint32_t>(strings.size()),
+             static_cast<std::uint32_t>(spelling.size())};
+      strings.append(spelling);
+      return ref;
+    };
+    auto offset = [&](SourceLoc loc) {
+      return loc.valid() ? static_cast<std::uint32_t>(source.offset(loc)) : no_offset;
+    };
+
+    for (auto const &import : module.imports) {
+      imports.push_back({str(import.module), offset(import.loc)});
+    }
+
+    // Only what other sources can refer to, function definitions being lowered along
+    // with the source that defines them
+    for (auto const *child : module.root()->children()) {
+      auto tag = DeclTag{};
+      switch (child->kind()) {
+      case NodeKind::eOpenDecl:
+        tag = DeclTag::eOpen;
+        break;
+      case NodeKind::eExternDecl:
+        tag = DeclTag::eExtern;
+        break;
+      default:
+        continue;
+      }
+
+      auto decl = DeclRecord{
+        tag, offset(child->loc()), str(child->id()), {}, {}, no_offset, 0, 0};
+
+      if (auto const *edecl = node_cast<ExternDecl>(child)) {
+        decl.return_type    = str(edecl->return_type());
+        decl.linkage_name   = str(edecl->linkage_name_literal()->id());
+        decl.linkage_offset = offset(edecl->linkage_name_literal()->loc());
+        decl.first_arg      = static_cast<std::uint32_t>(args.size());
+        decl.num_args       = static_cast<std::uint32_t>(edecl->args().size());
+        for (auto const &arg : edecl->args()) {
+          args.push_back({str(arg.name), str(arg.type)});
+        }
+      }
+      decls.push_back(decl);
+    }
+
+    auto header = Header{magic, format_version, compiler_hash(), key.hash,
+      static_cast<std::uint32_t>(imports.size()),
+      static_cast<std::uint32_t>(decls.size()),
+      static_cast<std::uint32_t>(args.size()),
+      static_cast<std::uint32_t>(strings.size())};
+
+    std::string bytes{};
+    append(bytes, std::span<Header const>{&header, 1});
+    append(bytes, std::span<ImportRecord const>{imports});
+    append(bytes, std::span<DeclRecord const>{decls});
+    append(bytes, std::span<ArgRecord const>{args});
+    bytes.append(strings);
+
+    auto error = std::error_code{};
+    std::filesystem::create_directories(dir_, error);
+    return not error and write_atomically(path(key), bytes);
+  }
+
+  std::filesystem::path ModuleInterfaceCache::path(ModuleKey const &key) const {
+    // Named after the source, and told apart from others of the same name by their path
+    auto name = std::ostringstream{};
+    name << std::filesystem::path{key.path}.stem().string() << '-' << std::hex
+         << std::setw(16) << std::setfill('0')
+         << robin_hood::hash_bytes(key.path.data(), key.path.size()) << ".clrm";
+    return dir_ / name.str();
+  }
+
+} // namespace claire::parser
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <filesystem>
+
+#include "../source.hpp"
+#include "module_cache.hpp"
+
+namespace claire::parser {
+
+  /// Precompiled module interfaces, `.clrm` files in a cache directory, which spare later
+  /// builds from lexing and parsing the modules they open
+  ///
+  /// An interface holds what other sources see of a module: the modules it opens and its
+  /// `extern` declarations, with their signatures and linkage names. It is stamped with
+  /// the hash of its source and of the compiler version, and is only loaded while both
+  /// still match. Loading maps the file and builds the declarations straight from its
+  /// fixed-size records, with no lexing nor parsing.
+  ///
+  /// Interfaces are written to a temporary file that is then renamed over the previous
+  /// one, so that builds sharing the directory only ever see whole files.
+  class ModuleInterfaceCache {
+    std::filesystem::path dir_;
+
+  public:
+    explicit ModuleInterfaceCache(std::filesystem::path dir);
+
+    /// Builds the module cached under `key` from its interface
+    ///
+    /// \param source source of the module, which locations are resolved against
+    /// \param module named module, whose tree and imports are filled in
+    /// \return whether an up-to-date interface was found
+    bool load(ModuleKey const &key, Source const &source, Module &module) const;
+
+    /// Writes the interface of the module cached under `key`, unless it has errors
+    ///
+    /// \param source source `module` was parsed from
+    /// \return whether the interface was written
+    bool store(ModuleKey const &key, Source const &source, Module const &module) const;
+
+    /// \return path of the interface of the module cached under `key`
+    [[nodiscard]] std::filesystem::path path(ModuleKey const &key) const;
+  };
+
+} // namespace claire::parser
@@ -0,0 +1,209 @@
+#include "module_loader.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+#include "lexer.hpp"
+#include "module_interface.hpp"
+
+namespace claire::parser {
+
+  namespace {
+
+    /// Modules opened by a source, but those it declares itself, from its tokens alone
+    std::vector<Import> scan_imports(TokenBuffer const &tokens) {
+      robin_hood::unordered_flat_set<Symbol> declared{};
+      std::vector<Import>                    imports{};
+
+      auto kinds = tokens.kinds();
+      for (std::size_t i = 1; i < kinds.size(); ++i) {
+        if (kinds[i] != TokenKind::eIdentifier) {
+          continue;
+        }
+        if (kinds[i - 1] == TokenKind::eReservedModule) {
+          declared.insert(tokens.symbol(i));
+        } else if (kinds[i - 1] == TokenKind::eReservedOpen) {
+          imports.push_back({tokens.symbol(i), tokens.loc(i)});
+        }
+      }
+
+      std::erase_if(
+        imports, [&](Import const &import) { return declared.contains(import.module); });
+      return imports;
+    }
+
+  } // namespace
+
+  bool ModuleRegistry::claim(Symbol name) {
+    auto lock = std::unique_lock{mutex_};
+    return modules_.try_emplace(name).second;
+  }
+
+  void ModuleRegistry::publish(Symbol name, Module const *module, std::string error) {
+    {
+      auto  lock      = std::unique_lock{mutex_};
+      auto &entry     = modules_.find(name)->second;
+      entry.module    = module;
+      entry.error     = std::move(error);
+      entry.published = true;
+    }
+    published_.notify_all();
+  }
+
+  Module const *ModuleRegistry::wait(Symbol name) const {
+    auto        lock  = std::unique_lock{mutex_};
+    auto const &entry = modules_.find(name)->second;
+    published_.wait(lock, [&]() { return entry.published; });
+    return entry.module;
+  }
+
+  Module const *ModuleRegistry::find(Symbol name) const {
+    auto lock = std::unique_lock{mutex_};
+    if (auto it = modules_.find(name); it != modules_.end() and it->second.published) {
+      return it->second.module;
+    }
+    return nullptr;
+  }
+
+  std::string ModuleRegistry::error(Symbol name) const {
+    auto lock = std::unique_lock{mutex_};
+    return modules_.find(name)->second.error;
+  }
+
+  std::size_t ModuleRegistry::size() const {
+    auto lock = std::unique_lock{mutex_};
+    return modules_.size();
+  }
+
+  ModuleLoader::ModuleLoader(
+    std::vector<std::filesystem::path> search_paths, std::size_t num_threads)
+    : search_paths_{std::move(search_paths)}
+    , owned_cache_{std::make_unique<ModuleCache>()}
+    , cache_{*owned_cache_}
+    , pool_{num_threads} {
+  }
+
+  ModuleLoader::ModuleLoader(std::vector<std::filesystem::path> search_paths,
+    ModuleCache &cache, std::size_t num_threads)
+    : search_paths_{std::move(search_paths)}
+    , cache_{cache}
+    , pool_{num_threads} {
+  }
+
+  Parser::Result ModuleLoader::load(std::string const &path) {
+    auto const &source  = *programs_.emplace_back(std::make_unique<Source const>(path));
+    auto        program = Module{intern("main"), path};
+    parse<ProgramDecl>(source, program);
+
+    auto diagnostics = std::move(program.diagnostics);
+
+    // Every module the program depends on, breadth first
+    std::vector<Module const *>                    modules{&program};
+    robin_hood::unordered_flat_set<Module const *> seen{};
+
+    for (std::size_t i = 0; i < modules.size(); ++i) {
+      for (auto const &import : modules[i]->imports) {
+        auto const *module = registry_.wait(import.module);
+        if (auto error = module ? std::string{} : registry_.error(import.module);
+            not error.empty()) {
+          diagnostics.report({DiagnosticKind::eModuleNotLoaded, import.loc,
+            std::string{import.module.str()} + ": " + error});
+        } else if (not module) {
+          diagnostics.report({DiagnosticKind::eModuleNotFound, import.loc,
+            std::string{import.module.str()}});
+        } else if (seen.insert(module).second) {
+          diagnostics.append(Diagnostics{module->diagnostics});
+          modules.push_back(module);
+        }
+      }
+    }
+
+    if (not diagnostics.empty()) {
+      return Unexpected{std::move(diagnostics)};
+    }
+    return std::move(program.ast);
+  }
+
+  void ModuleLoader::schedule(Symbol name) {
+    if (registry_.claim(name)) {
+      pool_.submit([this, name]() { load_module(name); });
+    }
+  }
+
+  void ModuleLoader::load_module(Symbol name) {
+    Module const *module{};
+    std::string   error{};
+    try {
+      if (auto path = find(name); not path.empty()) {
+        // Read again to hash it, which costs far less than lexing and parsing it
+        auto source = std::make_unique<Source const>(path.string());
+        auto key    = module_key(path.string(), *source);
+        // Waits if another name or loader is parsing the same source, never in the parse
+        module      = &cache_.get(key, [&](Module &parsed) {
+          parsed.name            = name;
+          parsed.path            = path.string();
+          // Built from its precompiled interface rather than parsed, while it is current
+          auto const *interfaces = cache_.interfaces();
+          if (not interfaces or not interfaces->load(key, *source, parsed)) {
+            parse<ModuleDecl>(*source, parsed);
+            if (interfaces) {
+              interfaces->store(key, *source, parsed);
+            }
+          }
+          parsed.source = std::move(source);
+        });
+        schedule_imports(*module);
+      }
+    } catch (std::exception const &e) {
+      // Reported wherever the module is opened. Its imports may not all be scheduled, so
+      // none of them are waited on.
+      module = nullptr;
+      error  = e.what();
+    } catch (...) {
+      module = nullptr;
+      error  = "unknown error";
+    }
+    registry_.publish(name, module, std::move(error));
+  }
+
+  void ModuleLoader::schedule_imports(Module const &module) {
+    for (auto const &import : module.imports) {
+      schedule(import.module);
+    }
+  }
+
+  std::filesystem::path ModuleLoader::find(Symbol name) const {
+    auto exact = std::string{name.str()};
+    auto lower = exact;
+    std::ranges::transform(
+      lower, lower.begin(), [](unsigned char c) { return std::tolower(c); });
+
+    for (auto const &dir : search_paths_) {
+      for (auto const &stem : {exact, lower}) {
+        // Unreadable directories are skipped like directories without the source
+        auto error = std::error_code{};
+        auto path  = dir / (stem + ".clr");
+        if (std::filesystem::is_regular_file(path, error)) {
+          // Names and paths that lead to the same source share its module
+          auto canonical = std::filesystem::canonical(path, error);
+          return error ? path : canonical;
+        }
+      }
+    }
+    return {};
+  }
+
+  template <typename RootNodeType>
+  void ModuleLoader::parse(Source const &source, Module &module) {
+    auto tokens    = Lexer{source}.tokenize_buffer(module.diagnostics);
+    module.imports = scan_imports(tokens);
+    schedule_imports(module);
+
+    auto  ctx  = parse_context{tokens};
+    auto *root = Parser{}.parse<RootNodeType>(ctx, module.name);
+    ctx.ast.set_root(root);
+    module.diagnostics.append(std::move(ctx.diagnostics));
+    module.ast = std::move(ctx.ast);
+  }
+
+} // namespace claire::parser
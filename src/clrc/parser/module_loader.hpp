@@ -0,0 +1,143 @@
+#pragma once
+
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <robin_hood.h>
+
+#include "../diagnostics.hpp"
+#include "../source.hpp"
+#include "../symbol.hpp"
+#include "../thread_pool.hpp"
+#include "ast.hpp"
+#include "module_cache.hpp"
+#include "parser.hpp"
+
+namespace claire::parser {
+
+  /// Modules of a build by name, shared by the threads loading them
+  ///
+  /// Each name is claimed once, by the thread that schedules its loading, and then
+  /// published once its module is parsed or known to be missing. Threads needing it in
+  /// the meantime block in `wait`. Names only refer to modules, which are owned by a
+  /// `ModuleCache`, so that names opening the same source share a single module.
+  class ModuleRegistry {
+    struct Entry {
+      bool          published{};
+      // Null if no source was found, or if it failed to load
+      Module const *module{};
+      // Why the source found failed to load, if it did
+      std::string   error{};
+    };
+
+    mutable std::mutex              mutex_;
+    mutable std::condition_variable published_;
+    // Nodes never move, so waiters can hold on to their entry
+    robin_hood::unordered_node_map<Symbol, Entry> modules_;
+
+  public:
+    /// \return whether `name` was not claimed yet, in which case the caller publishes it
+    bool claim(Symbol name);
+
+    /// \param module null if no source was found, or if it failed to load
+    /// \param error why the source found failed to load, empty if it did not
+    /// \pre `name` was claimed by the caller
+    void publish(Symbol name, Module const *module, std::string error = {});
+
+    /// Blocks until module `name` is published
+    ///
+    /// \return the module, nullptr if no source was found
+    /// \pre `name` was claimed
+    [[nodiscard]] Module const *wait(Symbol name) const;
+
+    /// \return module `name` if it is published and was found, nullptr otherwise
+    [[nodiscard]] Module const *find(Symbol name) const;
+
+    /// \return why the source of module `name` failed to load, empty if it did not
+    /// \pre `name` was published
+    [[nodiscard]] std::string error(Symbol name) const;
+
+    /// \return the number of names claimed
+    [[nodiscard]] std::size_t size() const;
+  };
+
+  /// Loads a program along with every module it opens, transitively, parsing them all in
+  /// parallel
+  ///
+  /// Module `Name` is parsed from the first `Name.clr`, or else lowercase `name.clr`,
+  /// found in the search paths. As soon as a source is lexed, its tokens are scanned for
+  /// `open` declarations and the modules they name are scheduled, before the source
+  /// itself is parsed. Sources are lexed and parsed as tasks on a work-stealing pool,
+  /// so that a build takes about as long as its largest module rather than their sum.
+  ///
+  /// Modules come from a `ModuleCache`, which may be shared with other loaders to parse
+  /// each source once per process rather than once per build.
+  ///
+  /// Search paths end with the standard library, so that modules of a program shadow it.
+  class ModuleLoader {
+    std::vector<std::filesystem::path>        search_paths_;
+    std::unique_ptr<ModuleCache>              owned_cache_;
+    ModuleCache                              &cache_;
+    // Sources of the programs loaded, which diagnostics and trees point into
+    std::vector<std::unique_ptr<Source const>> programs_;
+    ModuleRegistry                            registry_;
+    // Last, so that tasks are done before the registry goes away
+    ThreadPool                                pool_;
+
+  public:
+    /// Loader with a cache of its own
+    ///
+    /// \param search_paths directories searched in order, the standard library last
+    explicit ModuleLoader(std::vector<std::filesystem::path> search_paths,
+      std::size_t num_threads = std::thread::hardware_concurrency());
+
+    /// \param search_paths directories searched in order, the standard library last
+    /// \param cache outlives the loader
+    ModuleLoader(std::vector<std::filesystem::path> search_paths, ModuleCache &cache,
+      std::size_t num_threads = std::thread::hardware_concurrency());
+
+    /// Parses the program at `path` and the modules it opens
+    ///
+    /// The program is parsed on the calling thread while the modules it opens are, and
+    /// then waits on each of them in the order they are first opened. Its source lives
+    /// as long as the loader.
+    ///
+    /// \return tree of the program, or every diagnostic found in the program and its
+    ///         modules, missing modules included
+    /// \throws source_error if the program cannot be read
+    Parser::Result load(std::string const &path);
+
+    /// Modules opened so far, which live as long as the cache
+    [[nodiscard]] ModuleRegistry const &registry() const {
+      return registry_;
+    }
+
+  private:
+    /// Loads module `name` on the pool, unless it is already claimed
+    void schedule(Symbol name);
+
+    /// Publishes module `name`, parsing its source unless it is cached
+    ///
+    /// Runs as a task on the pool, so it never throws. Whatever fails is published as
+    /// the reason the module failed to load.
+    void load_module(Symbol name);
+
+    /// \return path of the source of module `name`, empty if there is none
+    /// \throws std::bad_alloc
+    [[nodiscard]] std::filesystem::path find(Symbol name) const;
+
+    /// Lexes `source`, schedules the modules it opens, then parses it into `module`
+    template <typename RootNodeType>
+    void parse(Source const &source, Module &module);
+
+    /// Schedules the modules opened by a cached module, which are claimed by whichever
+    /// loader parsed it but not necessarily by this one
+    void schedule_imports(Module const &module);
+  };
+
+} // namespace claire::parser
@@ -0,0 +1,246 @@
+#include "numeral.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <string>
+
+namespace claire::parser {
+
+  namespace {
+
+    //---------------------------------------------------------------------------------------
+    // SWAR decimal digits
+    //---------------------------------------------------------------------------------------
+
+    std::uint64_t load8(char const *ptr) {
+      std::uint64_t chunk;
+      std::memcpy(&chunk, ptr, sizeof(chunk));
+      return chunk;
+    }
+
+    // True if all 8 bytes are ASCII digits
+    bool is_eight_digits(std::uint64_t chunk) {
+      return ((chunk & 0xf0f0f0f0f0f0f0f0u) |
+               (((chunk + 0x0606060606060606u) & 0xf0f0f0f0f0f0f0f0u) >> 4)) ==
+             0x3333333333333333u;
+    }
+
+    // Value of 8 ASCII digits, the first of them in the lowest byte
+    std::uint32_t parse_eight_digits(std::uint64_t chunk) {
+      constexpr std::uint64_t mask = 0x000000ff000000ffu;
+      constexpr std::uint64_t mul1 = 100 + (1000000ull << 32);
+      constexpr std::uint64_t mul2 = 1 + (10000ull << 32);
+
+      chunk -= 0x3030303030303030u;
+      chunk = (chunk * 10) + (chunk >> 8);
+      return static_cast<std::uint32_t>(
+        (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32);
+    }
+
+    enum class Decoded {
+      eValue,
+      eOverflow,
+      eInvalid,
+    };
+
+    Decoded decode_decimal(std::string_view digits, std::uint64_t &value) {
+      value = 0;
+
+      // Keeps validating past an overflow, the numeral may still be malformed
+      bool        overflow = false;
+      std::size_t i        = 0;
+      for (; i + 8 <= digits.size(); i += 8) {
+        auto chunk = load8(digits.data() + i);
+        if (not is_eight_digits(chunk)) {
+          return Decoded::eInvalid;
+        }
+        overflow |= __builtin_mul_overflow(value, std::uint64_t{100000000}, &value);
+        overflow |= __builtin_add_overflow(value, parse_eight_digits(chunk), &value);
+      }
+
+      for (; i < digits.size(); ++i) {
+        auto digit = static_cast<unsigned>(digits[i] - '0');
+        if (digit >= 10) {
+          return Decoded::eInvalid;
+        }
+        overflow |= __builtin_mul_overflow(value, std::uint64_t{10}, &value);
+        overflow |= __builtin_add_overflow(value, std::uint64_t{digit}, &value);
+      }
+      return overflow ? Decoded::eOverflow : Decoded::eValue;
+    }
+
+    //---------------------------------------------------------------------------------------
+    // Power of two radixes
+    //---------------------------------------------------------------------------------------
+
+    constexpr std::uint8_t no_digit = 0xff;
+
+    constexpr auto make_digit_values() {
+      std::array<std::uint8_t, 256> values{};
+      for (auto &value : values) {
+        value = no_digit;
+      }
+      for (int ch = '0'; ch <= '9'; ++ch) {
+        values[ch] = static_cast<std::uint8_t>(ch - '0');
+      }
+      for (int ch = 'a'; ch <= 'f'; ++ch) {
+        values[ch]              = static_cast<std::uint8_t>(ch - 'a' + 10);
+        values[ch - 'a' + 'A'] = static_cast<std::uint8_t>(ch - 'a' + 10);
+      }
+      return values;
+    }
+
+    constexpr auto digit_values = make_digit_values();
+
+    Decoded decode_radix(std::string_view digits, unsigned bits, std::uint64_t &value) {
+      value = 0;
+
+      bool overflow = false;
+      auto radix    = 1u << bits;
+      for (auto ch : digits) {
+        auto digit = digit_values[static_cast<unsigned char>(ch)];
+        if (digit >= radix) {
+          return Decoded::eInvalid;
+        }
+        overflow |= (value >> (64 - bits)) != 0;
+        value = (value << bits) | digit;
+      }
+      return overflow ? Decoded::eOverflow : Decoded::eValue;
+    }
+
+    //---------------------------------------------------------------------------------------
+    // Digit separators
+    //---------------------------------------------------------------------------------------
+
+    // Text of a numeral without its '_' separators, only copied if it has any
+    class Stripped {
+      std::array<char, 64> inline_;
+      std::string          spill_;
+      std::string_view     text_;
+
+    public:
+      explicit Stripped(std::string_view text)
+        : text_{text} {
+      }
+
+      /// \param radix radix of the digits separators must sit between
+      /// \return false if a separator is not in between two digits
+      bool strip(unsigned radix) {
+        if (not std::memchr(text_.data(), '_', text_.size())) {
+          return true;
+        }
+
+        char *out = inline_.data();
+        if (text_.size() > inline_.size()) {
+          spill_.resize(text_.size());
+          out = spill_.data();
+        }
+
+        auto is_digit = [&](std::size_t i) {
+          return i < text_.size() and
+                 digit_values[static_cast<unsigned char>(text_[i])] < radix;
+        };
+
+        std::size_t len = 0;
+        for (std::size_t i = 0; i < text_.size(); ++i) {
+          if (text_[i] != '_') {
+            out[len++] = text_[i];
+          } else if (i == 0 or not is_digit(i - 1) or not is_digit(i + 1)) {
+            return false;
+          }
+        }
+
+        text_ = {out, len};
+        return true;
+      }
+
+      [[nodiscard]] std::string_view text() const {
+        return text_;
+      }
+    };
+
+    bool is_float(std::string_view text) {
+      for (auto ch : text) {
+        if (ch == '.' or ch == 'e' or ch == 'E') {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    // float ::= digits ( '.' digits? )? ( ( 'e' | 'E' ) ( '+' | '-' )? digits )?
+    bool is_well_formed_float(std::string_view text) {
+      std::size_t i      = 0;
+      auto        digits = [&]() {
+        auto start = i;
+        while (i < text.size() and static_cast<unsigned>(text[i] - '0') < 10) {
+          ++i;
+        }
+        return i > start;
+      };
+
+      if (not digits()) {
+        return false;
+      }
+      if (i < text.size() and text[i] == '.') {
+        ++i;
+        digits();
+      }
+      if (i < text.size() and (text[i] == 'e' or text[i] == 'E')) {
+        ++i;
+        if (i < text.size() and (text[i] == '+' or text[i] == '-')) {
+          ++i;
+        }
+        if (not digits()) {
+          return false;
+        }
+      }
+      return i == text.size();
+    }
+
+  } // namespace
+
+  std::optional<NumeralValue> decode_numeral(std::string_view text) {
+    auto prefix = std::string_view{};
+    auto bits   = 0u;
+    if (text.size() > 2 and text[0] == '0') {
+      if (text[1] == 'x' or text[1] == 'X') {
+        prefix = "0x";
+        bits   = 4;
+      } else if (text[1] == 'b' or text[1] == 'B') {
+        prefix = "0b";
+        bits   = 1;
+      }
+    }
+
+    auto body = Stripped{text.substr(prefix.size())};
+    if (not body.strip(bits == 0 ? 10 : 1u << bits) or body.text().empty()) {
+      return std::nullopt;
+    }
+    auto digits = body.text();
+
+    if (bits == 0 and is_float(digits)) {
+      double value{};
+      auto [end, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), value);
+      if (not is_well_formed_float(digits) or ec != std::errc{} or
+          end != digits.data() + digits.size()) {
+        return std::nullopt;
+      }
+      return NumeralValue::floating(value);
+    }
+
+    std::uint64_t value{};
+    auto          decoded =
+      bits == 0 ? decode_decimal(digits, value) : decode_radix(digits, bits, value);
+
+    switch (decoded) {
+    case Decoded::eValue:
+      return NumeralValue::integer(value);
+    case Decoded::eOverflow:
+      return NumeralValue::big_integer(intern(std::string{prefix}.append(digits)));
+    default:
+      return std::nullopt;
+    }
+  }
+
+} // namespace claire::parser
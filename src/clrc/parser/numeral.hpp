@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "../symbol.hpp"
+
+namespace claire::parser {
+
+  enum class NumeralKind : std::uint8_t {
+    eNone,
+    eInteger,
+    eFloat,
+    // Integer that does not fit 64 bits, kept as its digits
+    eBigInteger,
+  };
+
+  /// Decoded value of a numeric literal
+  ///
+  /// Stored bytewise so that it packs into the padding of a `Token`.
+  class NumeralValue {
+    std::array<std::uint8_t, 8> bits_;
+    NumeralKind                 kind_;
+
+    constexpr NumeralValue(std::uint64_t bits, NumeralKind kind)
+      : bits_{std::bit_cast<std::array<std::uint8_t, 8>>(bits)}
+      , kind_{kind} {
+    }
+
+  public:
+    constexpr NumeralValue()
+      : NumeralValue{0, NumeralKind::eNone} {
+    }
+
+    static constexpr NumeralValue integer(std::uint64_t value) {
+      return {value, NumeralKind::eInteger};
+    }
+
+    static constexpr NumeralValue floating(double value) {
+      return {std::bit_cast<std::uint64_t>(value), NumeralKind::eFloat};
+    }
+
+    /// \param digits radix prefix and digits, without digit separators
+    static constexpr NumeralValue big_integer(Symbol digits) {
+      return {digits.id(), NumeralKind::eBigInteger};
+    }
+
+    [[nodiscard]] constexpr NumeralKind kind() const {
+      return kind_;
+    }
+
+    [[nodiscard]] constexpr std::uint64_t integer() const {
+      return std::bit_cast<std::uint64_t>(bits_);
+    }
+
+    [[nodiscard]] constexpr double floating() const {
+      return std::bit_cast<double>(bits_);
+    }
+
+    [[nodiscard]] constexpr Symbol big_integer() const {
+      return Symbol{static_cast<std::uint32_t>(integer())};
+    }
+
+    friend constexpr bool operator==(NumeralValue const &lhs, NumeralValue const &rhs) = default;
+  };
+
+  /// Decodes the text of a numeral lexeme
+  ///
+  /// decimal ::= digit ( '_'? digit )*
+  /// hexadecimal ::= "0x" hexDigit ( '_'? hexDigit )*
+  /// binary ::= "0b" ( '0' | '1' ) ( '_'? ( '0' | '1' ) )*
+  /// float ::= decimal '.' decimal? exponent? | decimal exponent
+  /// exponent ::= ( 'e' | 'E' ) ( '+' | '-' )? decimal
+  ///
+  /// \param text
+  /// \return decoded value, or std::nullopt if `text` is not a well-formed numeral
+  std::optional<NumeralValue> decode_numeral(std::string_view text);
+
+} // namespace claire::parser
@@ -0,0 +1,163 @@
+#include "parse_automaton.hpp"
+
+namespace claire::parser {
+
+  namespace {
+
+    using enum ParseState;
+
+    constexpr TokenKind type_kinds[]{
+      TokenKind::eIdentifier,
+      TokenKind::eTypeBinary,
+      TokenKind::eTypeU32,
+    };
+
+    // Tokens that may start an expression statement
+    constexpr TokenKind expression_kinds[]{
+      TokenKind::eIdentifier,
+      TokenKind::eNumeral,
+      TokenKind::eStringLiteral,
+      TokenKind::eLParens,
+      TokenKind::eMinus,
+    };
+
+    constexpr void on(ParseTable &table, ParseState state, TokenKind kind,
+      ParseState next, ParseAction action) {
+      table[utype(state)][utype(kind)] = {next, action};
+    }
+
+    /// Argument list from its opening parenthesis, which is left in state `args`
+    ///
+    /// args ::= '(' ( identifier ':' type ','? )* ')'
+    constexpr void on_args(ParseTable &table, ParseState name, ParseState args,
+      ParseState arg_name, ParseState arg_colon, ParseState signature) {
+      on(table, name, TokenKind::eLParens, args, ParseAction::eShift);
+      on(table, args, TokenKind::eIdentifier, arg_name, ParseAction::eArgName);
+      on(table, args, TokenKind::eSeparator, args, ParseAction::eShift);
+      on(table, args, TokenKind::eRParens, signature, ParseAction::eShift);
+      on(table, arg_name, TokenKind::eColon, arg_colon, ParseAction::eShift);
+      for (auto kind : type_kinds) {
+        on(table, arg_colon, kind, args, ParseAction::eArgType);
+      }
+    }
+
+    // Anything not listed is a syntax error
+    constexpr ParseTable make_parse_table() {
+      ParseTable table{};
+
+      // decl ::= open | module | extern | func | let | expr ';'?
+      on(table, eDecls, TokenKind::eReservedOpen, eOpen, ParseAction::eShift);
+      on(table, eDecls, TokenKind::eReservedModule, eModule, ParseAction::eShift);
+      on(table, eDecls, TokenKind::eReservedExtern, eExtern, ParseAction::eShift);
+      on(table, eDecls, TokenKind::eReservedFunc, eFunc, ParseAction::eShift);
+      on(table, eDecls, TokenKind::eReservedLet, eLet, ParseAction::eShift);
+      on(table, eDecls, TokenKind::eSemicolon, eDecls, ParseAction::eShift);
+      on(table, eDecls, TokenKind::eScopeEnd, eDecls, ParseAction::eEndScope);
+      on(table, eDecls, TokenKind::eEndOfInput, eFinal, ParseAction::eAccept);
+      for (auto kind : expression_kinds) {
+        on(table, eDecls, kind, eDecls, ParseAction::eStatement);
+      }
+
+      // open ::= "open" identifier
+      on(table, eOpen, TokenKind::eIdentifier, eDecls, ParseAction::eOpen);
+
+      // module ::= "module" identifier '{' decl* '}'
+      on(table, eModule, TokenKind::eIdentifier, eModuleName, ParseAction::eName);
+      on(table, eModuleName, TokenKind::eScopeBegin, eDecls, ParseAction::eBeginModule);
+
+      // extern ::= "extern" identifier args ( "->" type )? stringLiteral
+      on(table, eExtern, TokenKind::eIdentifier, eExternName, ParseAction::eName);
+      on_args(table, eExternName, eExternArgs, eExternArgName, eExternArgColon,
+        eExternSignature);
+      on(table, eExternSignature, TokenKind::eArrow, eExternArrow, ParseAction::eShift);
+      on(table, eExternSignature, TokenKind::eStringLiteral, eDecls,
+        ParseAction::eExtern);
+      for (auto kind : type_kinds) {
+        on(table, eExternArrow, kind, eExternReturnType, ParseAction::eReturnType);
+      }
+      on(table, eExternReturnType, TokenKind::eStringLiteral, eDecls,
+        ParseAction::eExtern);
+
+      // func ::= "func" identifier args ( "->" type )? '{' decl* '}'
+      on(table, eFunc, TokenKind::eIdentifier, eFuncName, ParseAction::eName);
+      on_args(table, eFuncName, eFuncArgs, eFuncArgName, eFuncArgColon, eFuncSignature);
+      on(table, eFuncSignature, TokenKind::eArrow, eFuncArrow, ParseAction::eShift);
+      on(table, eFuncSignature, TokenKind::eScopeBegin, eDecls, ParseAction::eBeginFunc);
+      for (auto kind : type_kinds) {
+        on(table, eFuncArrow, kind, eFuncReturnType, ParseAction::eReturnType);
+      }
+      on(table, eFuncReturnType, TokenKind::eScopeBegin, eDecls, ParseAction::eBeginFunc);
+
+      // let ::= "let" identifier ( '\' identifier ( ':' type )? )*
+      //         ( "when" expr )? '=' expr
+      on(table, eLet, TokenKind::eIdentifier, eLetName, ParseAction::eName);
+      on(table, eLetArg, TokenKind::eIdentifier, eLetArgName, ParseAction::eArgName);
+      on(table, eLetArgName, TokenKind::eColon, eLetArgColon, ParseAction::eShift);
+      for (auto kind : type_kinds) {
+        on(table, eLetArgColon, kind, eLetArgType, ParseAction::eArgType);
+      }
+      for (auto state : {eLetName, eLetArgName, eLetArgType}) {
+        on(table, state, TokenKind::eBackslash, eLetArg, ParseAction::eShift);
+        on(table, state, TokenKind::eReservedWhen, eLetGuard, ParseAction::eGuard);
+        on(table, state, TokenKind::eAssign, eDecls, ParseAction::eLet);
+      }
+      on(table, eLetGuard, TokenKind::eAssign, eDecls, ParseAction::eLet);
+
+      return table;
+    }
+
+  } // namespace
+
+  constinit ParseTable const parse_trans = make_parse_table();
+
+  char const *expected_in(ParseState state) {
+    switch (state) {
+    case eDecls:
+      return "expected declaration or expression";
+    case eOpen:
+    case eModule:
+      return "expected module name";
+    case eModuleName:
+      return "expected '{'";
+    case eExtern:
+    case eFunc:
+    case eLet:
+      return "expected name";
+    case eExternName:
+    case eFuncName:
+      return "expected '('";
+    case eExternArgs:
+    case eFuncArgs:
+      return "expected argument or ')'";
+    case eExternArgName:
+    case eFuncArgName:
+      return "expected ':'";
+    case eLetArgName:
+      return "expected ':', '\\', 'when' or '='";
+    case eExternArgColon:
+    case eFuncArgColon:
+    case eLetArgColon:
+    case eExternArrow:
+    case eFuncArrow:
+      return "expected type";
+    case eExternSignature:
+      return "expected '->' or linkage name";
+    case eExternReturnType:
+      return "expected linkage name";
+    case eFuncSignature:
+      return "expected '->' or '{'";
+    case eFuncReturnType:
+      return "expected '{'";
+    case eLetArg:
+      return "expected argument";
+    case eLetName:
+    case eLetArgType:
+      return "expected '\\', 'when' or '='";
+    case eLetGuard:
+      return "expected '='";
+    default:
+      return "unexpected token";
+    }
+  }
+
+} // namespace claire::parser
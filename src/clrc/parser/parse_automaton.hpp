@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "../utils.hpp"
+#include "token.hpp"
+
+namespace claire::parser {
+
+  /// States of the declaration-level parser, each expecting a set of token kinds
+  ///
+  /// Nested scopes are kept on a stack by the parser, so that the states after a
+  /// declaration are the same at the top level and in the body of a module or function.
+  enum class ParseState : std::uint8_t {
+    eFinal,
+    eError,
+    // Between declarations
+    eDecls,
+    eOpen,
+    eModule,
+    eModuleName,
+    eExtern,
+    eExternName,
+    eExternArgs,
+    eExternArgName,
+    eExternArgColon,
+    eExternSignature,
+    eExternArrow,
+    eExternReturnType,
+    eFunc,
+    eFuncName,
+    eFuncArgs,
+    eFuncArgName,
+    eFuncArgColon,
+    eFuncSignature,
+    eFuncArrow,
+    eFuncReturnType,
+    eLet,
+    eLetName,
+    eLetArg,
+    eLetArgName,
+    eLetArgColon,
+    eLetArgType,
+    eLetGuard,
+    eCount,
+  };
+
+  /// What the parser does upon a transition, before moving on to the next state
+  ///
+  /// Every action but `eStatement` and `eAccept` consumes the token it is taken on.
+  enum class ParseAction : std::uint8_t {
+    eReject,
+    eShift,
+    eName,
+    eArgName,
+    eArgType,
+    eReturnType,
+    eOpen,
+    eBeginModule,
+    eBeginFunc,
+    eEndScope,
+    eExtern,
+    eGuard,
+    eLet,
+    eStatement,
+    eAccept,
+    eCount,
+  };
+
+  struct ParseTransition {
+    ParseState  next;
+    ParseAction action;
+  };
+
+  using ParseRow   = std::array<ParseTransition, utype(TokenKind::eCount)>;
+  using ParseTable = std::array<ParseRow, utype(ParseState::eCount)>;
+
+  // Declaration-level transitions, indexed by current state and upcoming token kind
+  extern ParseTable const parse_trans;
+
+  inline auto transition(ParseState curr, TokenKind kind) {
+    return parse_trans[utype(curr)][utype(kind)];
+  }
+
+  /// \return what the parser expected in state `state`, to report syntax errors
+  char const *expected_in(ParseState state);
+
+} // namespace claire::parser
@@ -1,26 +1,70 @@
+#include <array>
 #include <iostream>
+#include <vector>
 
 #include "lexer.hpp"
+#include "parse_automaton.hpp"
 #include "parser.hpp"
 
 namespace claire::parser {
 
+  namespace {
+
+    struct BindingPower {
+      // Towards the left operand, 0 for tokens that are not infix operators
+      std::uint8_t left;
+      std::uint8_t right;
+    };
+
+    // Left associative operators bind tighter to their right
+    constexpr auto binding_powers = []() {
+      std::array<BindingPower, utype(TokenKind::eCount)> table{};
+      table[utype(TokenKind::ePipe)]    = {1, 2};
+      table[utype(TokenKind::eLess)]    = {3, 4};
+      table[utype(TokenKind::eGreater)] = {3, 4};
+      table[utype(TokenKind::ePlus)]    = {5, 6};
+      table[utype(TokenKind::eMinus)]   = {5, 6};
+      return table;
+    }();
+
+    // Of prefix operators towards their operand
+    constexpr std::uint8_t prefix_binding_power = 7;
+
+    /// Operator waiting for its right operand, or an open parenthesis
+    struct PendingOperator {
+      TokenKind    op;
+      // 0 for parentheses, which operators are never reduced past
+      std::uint8_t right;
+      bool         prefix;
+      SourceLoc    loc;
+      // Call whose arguments the parenthesis opens, if any
+      FunctionCallExpr   *call{};
+      ExpressionSequence *args{};
+    };
+
+    bool ends_argument(TokenKind kind) {
+      return kind == TokenKind::eEndOfInput or kind == TokenKind::eSeparator or
+             kind == TokenKind::eRParens;
+    }
+
+  } // namespace
+
   /// Parses a simple identifier expression
   ///
   /// letter ::= [A-Za-z]
   /// digit ::= [0-9]
   /// identifierExpr ::= letter ( letter | digit | '_' )
   ///
-  /// \param tok
+  /// \param ctx
   /// \return
-  std::unique_ptr<IdentifierExpr> parse_simple_identifier_expression(
-    token_iterator &tok) {
-    if (tok->kind == TokenKind::eIdentifier) {
-      return std::make_unique<IdentifierExpr>(tok->repr);
-    } else {
-      // TODO(rw): collect errors
-      throw syntax_error{"expected valid identifier, got: {}"};
+  ParseResult<IdentifierExpr> parse_simple_identifier_expression(parse_context &ctx) {
+    auto tok = ctx.consume(TokenKind::eIdentifier, "valid identifier");
+    if (not tok) {
+      return Unexpected{std::move(tok).error()};
     }
+    auto *ident = ctx.make<IdentifierExpr>(tok->symbol);
+    ident->set_loc(tok->loc);
+    return ident;
   }
 
   /// Parses an identifier sequence
@@ -29,25 +73,47 @@ namespace claire::parser {
   /// accessMember ::= '.' identifierExpr
   /// identifierSeq ::= identifierExpr accessNamespace* accessMember*
   ///
-  /// \param tok
+  /// \param ctx
   /// \return
-  std::unique_ptr<IdentifierSeq> parse_identifier_sequence(token_iterator &tok) {
-    auto seq   = std::make_unique<IdentifierSeq>();
-    auto ident = parse_simple_identifier_expression(tok);
-    //    seq->add(parse_simple_identifier_expression(tok));
-
-    tok     = std::next(tok);
-    auto ns = std::make_unique<NamespaceAccessExpr>(std::move(ident));
-    for (; tok->kind == TokenKind::eAccessNamespace; ++tok) {
-      tok = std::next(tok);
-      ns->add(parse_simple_identifier_expression(tok));
+  ParseResult<IdentifierSeq> parse_identifier_sequence(parse_context &ctx) {
+    auto ident = parse_simple_identifier_expression(ctx);
+    if (not ident) {
+      return Unexpected{std::move(ident).error()};
+    }
+    // Named after its leading identifier, so that calls through it print their callee
+    auto *seq = ctx.make<IdentifierSeq>((*ident)->id());
+    //    seq->add(parse_simple_identifier_expression(ctx));
+
+    seq->set_loc((*ident)->loc());
+    auto *ns = ctx.make<NamespaceAccessExpr>(*ident);
+    while (ctx.next_is(TokenKind::eAccessNamespace)) {
+      ctx.advance();
+      auto member = parse_simple_identifier_expression(ctx);
+      if (not member) {
+        // Keep the path up to the error
+        ctx.report(std::move(member).error());
+        break;
+      }
+      ns->add(*member);
     }
-    seq->add(std::move(ns));
+    seq->add(ns);
 
-    for (; tok->kind == TokenKind::eAccessMember; ++tok) {}
+    while (ctx.next_is(TokenKind::eAccessMember)) {
+      ctx.advance();
+      auto member = parse_simple_identifier_expression(ctx);
+      if (not member) {
+        ctx.report(std::move(member).error());
+        break;
+      }
+      seq->add(*member);
+    }
 
-    if (tok->kind == TokenKind::eAccessNamespace) {
-      throw syntax_error{"member identifier cannot contain nested namespace"};
+    if (ctx.next_is(TokenKind::eAccessNamespace)) {
+      ctx.report(make_syntax_error(
+        "member identifier cannot contain nested namespace", ctx.token().loc));
+      while (ctx.next_is(TokenKind::eAccessNamespace) or ctx.next_is(TokenKind::eIdentifier)) {
+        ctx.advance();
+      }
     }
 
     return seq;
@@ -62,231 +128,363 @@ namespace claire::parser {
   /// \param ctx
   /// \param callee
   /// \return
-  std::unique_ptr<FunctionCallExpr> parse_function_call_expression(
-    parse_context &ctx, std::unique_ptr<Expr> &&callee) {
-    auto call = std::make_unique<FunctionCallExpr>(std::move(callee));
-    // TODO(rw): create a consume func that can also assert token kind
-    //           maybe also a peek func via yield copy of token, suspend, and resume?
-
-    // eat left parens
-    ctx.tok  = std::next(ctx.tok);
-    auto seq = parse_expression_sequence(ctx);
+  ParseResult<FunctionCallExpr> parse_function_call_expression(
+    parse_context &ctx, Expr *callee) {
+    auto *call = ctx.make<FunctionCallExpr>(callee);
+
+    if (auto lparens = ctx.consume(TokenKind::eLParens, "'('"); not lparens) {
+      return Unexpected{std::move(lparens).error()};
+    }
+    auto *seq = parse_expression_sequence(ctx);
     if (not seq->children().empty()) {
-      call->add(std::move(seq));
+      call->add(seq);
+    }
+
+    if (auto rparens = ctx.consume(TokenKind::eRParens, "')'"); not rparens) {
+      // Arguments up to the error still make up the call
+      ctx.report(std::move(rparens).error());
+      ctx.synchronize(TokenKind::eRParens);
     }
-    // eat right parens
-    ctx.tok = std::next(ctx.tok);
     return call;
   }
 
-  std::unique_ptr<ExpressionSequence> parse_expression_sequence(parse_context &ctx) {
-    auto seq = std::make_unique<ExpressionSequence>();
-    // TODO(rw): reserve ',' as expression separator
-    // TODO(rw): better TokenKind checks
-    for (; ctx.tok != ctx.tokens.end() and ctx.tok->kind != TokenKind::eSeparator and
-           ctx.tok->kind != TokenKind::eRParens;
-         ++ctx.tok) {
-      // TODO(rw): generic parse_expr, stubbed as parse_identifier_expr for now
-      seq->add(std::make_unique<IdentifierExpr>(ctx.tok->repr));
+  /// Parses an expression
+  ///
+  /// primaryExpr ::= identifierExpr | identifierSeq | numeral | stringLiteral
+  ///               | '(' expr ')'
+  /// postfixExpr ::= primaryExpr ( '(' expressionSequence ')' )*
+  /// expr ::= ( '-' )* postfixExpr ( infixOperator expr )?
+  ///
+  /// Precedence comes from `binding_powers`. Operators and open parentheses wait on an
+  /// explicit stack rather than on the call stack, so that neither long chains of
+  /// operators nor deeply nested parentheses and calls grow the native stack.
+  ///
+  /// \param ctx
+  /// \return expression, or the first syntax error in it, past which parsing resumes
+  ParseResult<Expr> parse_expression(parse_context &ctx) {
+    std::vector<Expr *>          operands{};
+    std::vector<PendingOperator> pending{};
+    std::size_t                  open_parens{};
+
+    // Applies pending operators binding at least as tightly as `left`, back to the
+    // innermost open parenthesis
+    auto reduce = [&](std::uint8_t left) {
+      while (not pending.empty() and pending.back().right >= left) {
+        auto  top = pending.back();
+        auto *rhs = operands.back();
+        pending.pop_back();
+        operands.pop_back();
+
+        if (top.prefix) {
+          auto *unary = ctx.make<UnaryExpr>(top.op, rhs);
+          unary->set_loc(top.loc);
+          operands.push_back(unary);
+        } else {
+          operands.back() = ctx.make<BinaryExpr>(top.op, operands.back(), rhs);
+        }
+      }
+    };
+
+    // Skips past the parentheses still open, so that parsing resumes after them
+    auto fail = [&](Diagnostic error) -> ParseResult<Expr> {
+      while (open_parens > 0 and not ctx.next_is(TokenKind::eEndOfInput)) {
+        if (ctx.next_is(TokenKind::eLParens)) {
+          ++open_parens;
+        } else if (ctx.next_is(TokenKind::eRParens)) {
+          --open_parens;
+        }
+        ctx.advance();
+      }
+      return Unexpected{std::move(error)};
+    };
+
+    for (;;) {
+      auto tok = ctx.token();
+      switch (tok.kind) {
+      case TokenKind::eMinus:
+        pending.push_back({tok.kind, prefix_binding_power, true, tok.loc});
+        ctx.advance();
+        continue;
+      case TokenKind::eLParens:
+        pending.push_back({tok.kind, 0, false, tok.loc});
+        ++open_parens;
+        ctx.advance();
+        continue;
+      case TokenKind::eIdentifier: {
+        auto next = ctx.kind(1);
+        if (next == TokenKind::eAccessNamespace or next == TokenKind::eAccessMember) {
+          // Always succeeds, given a leading identifier
+          operands.push_back(*parse_identifier_sequence(ctx));
+          break;
+        }
+        auto *ident = ctx.make<IdentifierExpr>(tok.symbol);
+        ident->set_loc(tok.loc);
+        operands.push_back(ident);
+        ctx.advance();
+        break;
+      }
+      case TokenKind::eNumeral: {
+        auto *numeral = ctx.make<NumeralExpr>(intern(tok.repr), tok.value);
+        numeral->set_loc(tok.loc);
+        operands.push_back(numeral);
+        ctx.advance();
+        break;
+      }
+      case TokenKind::eStringLiteral: {
+        auto *literal = ctx.make<StringExpr>(intern(tok.repr));
+        literal->set_loc(tok.loc);
+        operands.push_back(literal);
+        ctx.advance();
+        break;
+      }
+      default:
+        return fail(make_syntax_error("expected expression", tok.loc));
+      }
+
+      // Calls and closing parentheses after the operand, up to an infix operator
+      for (;;) {
+        auto tok = ctx.token();
+        if (auto power = binding_powers[utype(tok.kind)]; power.left != 0) {
+          reduce(power.left);
+          pending.push_back({tok.kind, power.right, false, tok.loc});
+          ctx.advance();
+          break;
+        }
+
+        if (tok.kind == TokenKind::eLParens) {
+          auto *call = ctx.make<FunctionCallExpr>(operands.back());
+          operands.pop_back();
+          ctx.advance();
+          if (ctx.next_is(TokenKind::eRParens)) {
+            operands.push_back(call);
+            ctx.advance();
+            continue;
+          }
+
+          auto *args = ctx.make<ExpressionSequence>();
+          args->set_loc(ctx.token().loc);
+          pending.push_back({tok.kind, 0, false, tok.loc, call, args});
+          ++open_parens;
+          break;
+        }
+
+        reduce(1);
+        if (open_parens == 0) {
+          return operands.back();
+        }
+
+        auto &paren = pending.back();
+        if (paren.call and tok.kind == TokenKind::eSeparator) {
+          paren.args->add(operands.back());
+          operands.pop_back();
+          ctx.advance();
+          break;
+        }
+        if (tok.kind != TokenKind::eRParens) {
+          auto expected = paren.call ? "expected ',' or ')'" : "expected ')'";
+          return fail(make_syntax_error(expected, tok.loc));
+        }
+
+        if (paren.call) {
+          paren.args->add(operands.back());
+          paren.call->add(paren.args);
+          operands.back() = paren.call;
+        }
+        pending.pop_back();
+        --open_parens;
+        ctx.advance();
+      }
+    }
+  }
+
+  /// Parses the arguments of a call
+  ///
+  /// Syntax errors in an argument are reported, and parsing resumes with the next one.
+  ///
+  /// \param ctx
+  /// \return
+  ExpressionSequence *parse_expression_sequence(parse_context &ctx) {
+    auto *seq = ctx.make<ExpressionSequence>();
+    seq->set_loc(ctx.token().loc);
+    while (not ends_argument(ctx.kind())) {
+      if (auto expr = parse_expression(ctx)) {
+        seq->add(*expr);
+      } else {
+        ctx.report(std::move(expr).error());
+        // Resume with the next argument
+        while (not ends_argument(ctx.kind())) {
+          ctx.advance();
+        }
+      }
+
       // eat comma separator
-      ctx.tok = std::next(ctx.tok);
-      if (ctx.tok == ctx.tokens.end()) {
+      if (not ctx.next_is(TokenKind::eSeparator)) {
         break;
       }
+      ctx.advance();
     }
     return seq;
   }
 
+  /// Parses declarations up to the end of input, driven by `parse_trans`
+  ///
+  /// program ::= decl*
+  ///
+  /// Each token is looked up in the table for the current state, and the action found
+  /// there builds up the declaration being parsed. Bodies of modules and functions are
+  /// kept on a stack of scopes instead of being parsed recursively, and expressions are
+  /// left to `parse_expression`.
+  ///
+  /// On a syntax error, tokens are skipped until one that may start a declaration or
+  /// statement, or end a scope, and parsing resumes from there.
   template <typename RootNodeType>
-  std::unique_ptr<ASTNode> Parser::parse(
-    std::vector<Token> const &tokens, std::string const &id) {
-    auto root  = std::make_unique<RootNodeType>(id);
-    auto token = tokens.begin();
-
-    switch (token->kind) {
-      //    case TokenKind::eReservedFunc:
-      //      root->add(parse_function_def(token));
-      //      break;
-    default:
-      break;
+  ASTNode *Parser::parse(parse_context &ctx, Symbol id) {
+    auto *root = ctx.make<RootNodeType>(id);
+
+    // Innermost last, the root first
+    std::vector<ASTNode *> scopes{root};
+
+    // Parts of the declaration being parsed
+    SourceLoc                start{};
+    Symbol                   name{};
+    std::vector<FunctionArg> args{};
+    Symbol                   return_type{};
+    Expr                    *guard{};
+
+    auto reset = [&]() {
+      name        = {};
+      return_type = {};
+      guard       = nullptr;
+      args.clear();
+    };
+
+    auto recover = [&](Diagnostic error) {
+      ctx.report(std::move(error));
+      while (transition(ParseState::eDecls, ctx.kind()).action == ParseAction::eReject) {
+        ctx.advance();
+      }
+      reset();
+    };
+
+    auto add = [&](ASTNode *node) {
+      node->set_loc(start);
+      scopes.back()->add(node);
+    };
+
+    auto type_of = [](Token const &tok) {
+      return tok.kind == TokenKind::eIdentifier ? tok.symbol : intern(tok.repr);
+    };
+
+    for (auto state = ParseState::eDecls; state != ParseState::eFinal;) {
+      auto tok = ctx.token();
+      if (state == ParseState::eDecls) {
+        start = tok.loc;
+      }
+
+      auto trans = transition(state, tok.kind);
+      if (trans.action == ParseAction::eReject) {
+        recover(make_syntax_error(expected_in(state), tok.loc));
+        state = ParseState::eDecls;
+        continue;
+      }
+      state = trans.next;
+
+      switch (trans.action) {
+      case ParseAction::eShift:
+        break;
+      case ParseAction::eName:
+        name = tok.symbol;
+        break;
+      case ParseAction::eArgName:
+        args.push_back({tok.symbol, {}});
+        break;
+      case ParseAction::eArgType:
+        args.back().type = type_of(tok);
+        break;
+      case ParseAction::eReturnType:
+        return_type = type_of(tok);
+        break;
+      case ParseAction::eOpen:
+        add(ctx.make<OpenDecl>(tok.symbol));
+        break;
+      case ParseAction::eBeginModule: {
+        auto *module = ctx.make<ModuleDecl>(name);
+        add(module);
+        scopes.push_back(module);
+        reset();
+        break;
+      }
+      case ParseAction::eBeginFunc: {
+        auto *body = ctx.make<FunctionBody>();
+        body->set_loc(tok.loc);
+        auto *ident = ctx.make<IdentifierExpr>(name);
+        auto  copy  = ctx.ast.arena().copy(std::span<FunctionArg const>{args});
+        add(ctx.make<FunctionDef>(name, ident, copy, return_type, body));
+        scopes.push_back(body);
+        reset();
+        break;
+      }
+      case ParseAction::eEndScope:
+        if (scopes.size() == 1) {
+          ctx.report(make_syntax_error("unmatched '}'", tok.loc));
+        } else {
+          scopes.pop_back();
+        }
+        break;
+      case ParseAction::eExtern: {
+        auto *linkage_name = ctx.make<StringExpr>(intern(tok.repr));
+        linkage_name->set_loc(tok.loc);
+        auto copy = ctx.ast.arena().copy(std::span<FunctionArg const>{args});
+        add(ctx.make<ExternDecl>(name, copy, return_type, linkage_name));
+        reset();
+        break;
+      }
+      case ParseAction::eGuard:
+      case ParseAction::eLet: {
+        ctx.advance();
+        auto expr = parse_expression(ctx);
+        if (not expr) {
+          recover(std::move(expr).error());
+          state = ParseState::eDecls;
+          continue;
+        }
+        if (trans.action == ParseAction::eGuard) {
+          guard = *expr;
+          continue;
+        }
+
+        auto *body = ctx.make<FunctionBody>();
+        body->set_loc((*expr)->loc());
+        body->add(*expr);
+        auto *ident = ctx.make<IdentifierExpr>(name);
+        auto  copy  = ctx.ast.arena().copy(std::span<FunctionArg const>{args});
+        add(ctx.make<FunctionDef>(name, ident, copy, Symbol{}, body, guard));
+        reset();
+        continue;
+      }
+      case ParseAction::eStatement:
+        if (auto expr = parse_expression(ctx)) {
+          scopes.back()->add(*expr);
+        } else {
+          recover(std::move(expr).error());
+        }
+        continue;
+      case ParseAction::eAccept:
+        if (scopes.size() > 1) {
+          ctx.report(make_syntax_error("expected '}'", scopes.back()->loc()));
+        }
+        continue;
+      default:
+        break;
+      }
+      ctx.advance();
     }
 
     return root;
   }
 
-  //  std::unique_ptr<FunctionDef> Parser::parse_function_def(
-  //    std::vector<Token>::const_iterator &tok) {
-  //    tok              = std::next(tok);
-  //    auto id          = tok->repr;
-  //    auto symbol_name = std::make_unique<IdentifierExpr>(tok->repr);
-  //
-  //    tok       = std::next(tok);
-  //    auto args = parse_function_decl_args(tok);
-  //
-  //    // TODO(rw): parse return type decl
-  //
-  //    tok = std::next(tok);
-  //    if (tok->kind == TokenKind::eScopeBegin) {
-  //      auto body = parse_function_body(tok);
-  //      return std::make_unique<FunctionDef>(
-  //        id, std::move(symbol_name), std::move(args), std::move(body));
-  //    } else {
-  //      // TODO(rw): parse semicolon for func decl
-  //      throw syntax_error{};
-  //    }
-  //  }
-
-  //  std::unique_ptr<FunctionBody> Parser::parse_function_body(
-  //    std::vector<Token>::const_iterator &tok) {
-  //    tok       = std::next(tok);
-  //    auto body = std::make_unique<FunctionBody>();
-  //
-  //    for (; tok->kind != TokenKind::eScopeEnd;) {
-  //      switch (tok->kind) {
-  //      case TokenKind::eIdentifier:
-  //        body->add(parse_identifier_expr(tok));
-  //        break;
-  //      case TokenKind::eLParens:
-  //        body->add(parse_function_call_expr(tok));
-  //        break;
-  //      default:
-  //        throw syntax_error{};
-  //      }
-  //    }
-  //
-  //    return body;
-  //  }
-
-  //  template <typename ASTNodeType>
-  //  std::unique_ptr<ASTNode> Parser::parse(
-  //    std::vector<Token> const &tokens, std::string const &id) {
-  //    auto root  = std::make_unique<ASTNodeType>(id);
-  //    // TODO(rihtwis-weard): `NewScope` synonymous with an additional `Program` state?
-  //    auto state = ParseState::eNewScope;
-  //
-  //    for (auto tok = tokens.begin(); tok != tokens.end(); tok++) {
-  //      if (state = next_state(state, *tok); state <= ParseState::eFinal) {
-  //        return root;
-  //      }
-  //
-  //      switch (state) {
-  //      case ParseState::eIdentifierExpr: {
-  //        root->add(parse_identifier_expr(state, tok));
-  //        break;
-  //      }
-  //      case ParseState::eModuleOpenStmt: {
-  //        // TODO(rihtwis-weard): elide `open ModuleName` declaration for stdlib modules
-  //        root->add(parse_module_open_stmt(state, tok, tokens));
-  //        state = ParseState::eNewScope;
-  //        break;
-  //      }
-  //      case ParseState::eExternDecl: {
-  //        root->add(parse_extern_decl(state, tok, tokens));
-  //        break;
-  //      }
-  //      default:
-  //        break;
-  //      }
-  //    }
-  //
-  //    return root;
-  //  }
-
-  template std::unique_ptr<ASTNode> Parser::parse<ProgramDecl>(
-    std::vector<Token> const &tokens, std::string const &id);
-
-  template std::unique_ptr<ASTNode> Parser::parse<ModuleDecl>(
-    std::vector<Token> const &tokens, std::string const &id);
-
-  //  std::unique_ptr<Expr> Parser::parse_module_access_expr(
-  //    std::vector<Token>::const_iterator tok, IdentifierExpr const &expr) {
-  //
-  //    auto node = std::make_unique<ModuleAccessExpr>(expr);
-  //
-  //    for (auto state = ParseState::eNewAccessExpr; state > ParseState::eFinal;) {
-  //      if (state = next_state(state, *(++tok)); state <= ParseState::eFinal) {
-  //        return node;
-  //      }
-  //
-  //      if (state == ParseState::eGrowAccessExpr) {
-  //        node->grow(tok->repr);
-  //      } else if (state == ParseState::eFunctionCallExpr) {
-  //        return parse_function_call_expr(tok, std::move(node));
-  //      }
-  //    }
-  //    return node;
-  //  }
-
-  //  std::unique_ptr<ASTNode> Parser::parse_module_open_stmt(ParseState &state,
-  //    std::vector<Token>::const_iterator &tok, std::vector<Token> const &tokens) {
-  //
-  //    auto module_root = std::make_unique<ASTNode>();
-  //
-  //    for (; state > ParseState::eFinal;) {
-  //      if (++tok == tokens.end()) {
-  //        return module_root;
-  //      }
-  //
-  //      if (state = next_state(state, *tok); state <= ParseState::eFinal) {
-  //        return module_root;
-  //      }
-  //
-  //      if (state == ParseState::eIdentifierExpr) {
-  //        // TODO(rihwis-weard): correct way to cache repeated ASTNode/Module resolutions and returning
-  //        //                     unique_ptr to ASTNode? May need to use shared_ptr/weak_ptrs all around
-  //        //        if (auto mod = mod_map_.find(tok->repr); mod != mod_map_.end()) {
-  //        //          return std::unique_ptr<ASTNode>{mod->second.get()};
-  //        //        }
-  //
-  //        // TODO(rihtwis-weard): return `OpenModuleStmt` if `Module` is already loaded
-  //
-  //        // TODO(rihwis-weard): don't hard-code module lookup/resolution
-  //        // distribute module registry, file -> module names
-  //        auto toks = Lexer{stdlib_path_ + "io.clr"}.lex();
-  //
-  //        // TODO(rihtwis-weard): module not found exception or save error and keep parsing
-  //        return parse<ModuleDecl>(toks, tok->repr);
-  //      }
-  //    }
-  //
-  //    return module_root;
-  //  }
-  //
-  //  std::unique_ptr<ExternDecl> Parser::parse_extern_decl(ParseState &state,
-  //    std::vector<Token>::const_iterator tok, std::vector<Token> const &tokens) {
-  //
-  //    std::string              name{};
-  //    std::vector<FunctionArg> args{};
-  //    std::string              return_type{};
-  //    std::string              linkage_name{};
-  //
-  //    for (; state > ParseState::eFinal;) {
-  //      if (++tok == tokens.end()) {
-  //        return std::make_unique<ExternDecl>(
-  //          name, std::move(args), return_type, std::make_unique<StringExpr>(linkage_name));
-  //      }
-  //
-  //      if (state = next_state(state, *tok); state <= ParseState::eFinal) {
-  //        return std::make_unique<ExternDecl>(
-  //          name, std::move(args), return_type, std::make_unique<StringExpr>(linkage_name));
-  //      }
-  //
-  //      if (state == ParseState::eExternDeclName) {
-  //        name = tok->repr;
-  //      } else if (state == ParseState::eFunctionDeclArgs) {
-  //        args = parse_function_decl_args(tok);
-  //        --tok;
-  //      } else if (state == ParseState::eFunctionDeclReturnType) {
-  //        tok++;
-  //        return_type = tok->repr;
-  //        state       = ParseState::eExternDecl;
-  //      } else if (state == ParseState::eExternDeclLinkageName) {
-  //        linkage_name = tok->repr;
-  //      }
-  //    }
-  //
-  //    // TODO(rihtwis-weard): need to record errors
-  //    return nullptr;
-  //  }
+  template ASTNode *Parser::parse<ProgramDecl>(parse_context &ctx, Symbol id);
+
+  template ASTNode *Parser::parse<ModuleDecl>(parse_context &ctx, Symbol id);
 
 } // namespace claire::parser
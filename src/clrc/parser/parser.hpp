@@ -5,64 +5,147 @@
 
 #include <robin_hood.h>
 
+#include "../diagnostics.hpp"
+#include "../expected.hpp"
 #include "ast.hpp"
-#include "state_machine.h"
-#include "token.h"
+#include "token.hpp"
+#include "token_stream.hpp"
 
 namespace claire::parser {
 
-  using token_iterator = std::vector<Token>::const_iterator;
+  /// Node of a production, or the syntax error that kept it from being parsed
+  ///
+  /// Productions return an error when they cannot build their node at all. Callers
+  /// that can resume parsing past it report the error to `parse_context::diagnostics`
+  /// instead of passing it on, so that a single pass finds every syntax error.
+  template <typename NodeType>
+  using ParseResult = Expected<NodeType *, Diagnostic>;
 
-  struct parse_context {
-    std::vector<Token> const &tokens;
+  inline Diagnostic make_syntax_error(std::string message, SourceLoc loc) {
+    return {DiagnosticKind::eSyntaxError, loc, std::move(message)};
+  }
 
-    token_iterator tok;
+  struct parse_context {
+    TokenStream tokens;
+    // Syntax errors that parsing recovered from
+    Diagnostics diagnostics;
+    // Owner of every node parsed so far
+    AST         ast;
 
   public:
     explicit parse_context(std::vector<Token> const &tokens)
-      : tokens{tokens}
-      , tok{tokens.begin()} {
+      : tokens{std::span<Token const>{tokens}} {
+    }
+
+    explicit parse_context(TokenBuffer const &tokens)
+      : tokens{tokens} {
+    }
+
+    explicit parse_context(Lexer &lexer)
+      : tokens{lexer} {
+    }
+
+    /// \return kind of the n-th upcoming token, TokenKind::eEndOfInput past the end
+    TokenKind kind(std::size_t n = 0) {
+      return tokens.kind(n);
+    }
+
+    bool next_is(TokenKind kind) {
+      return tokens.kind() == kind;
+    }
+
+    Token token() {
+      return tokens.token();
+    }
+
+    void advance() {
+      tokens.advance();
+    }
+
+    template <typename NodeType, typename... Args>
+    NodeType *make(Args &&...args) {
+      return ast.make<NodeType>(std::forward<Args>(args)...);
+    }
+
+    /// Consumes the next token, which must be of the given kind
+    Expected<Token, Diagnostic> consume(TokenKind kind, char const *expected) {
+      auto tok = tokens.token();
+      if (tok.kind != kind) {
+        return Unexpected{make_syntax_error(std::string{"expected "} + expected, tok.loc)};
+      }
+
+      advance();
+      return tok;
+    }
+
+    void report(Diagnostic diagnostic) {
+      diagnostics.report(std::move(diagnostic));
+    }
+
+    /// Skips past the next token of the given kind, to resume after a syntax error
+    void synchronize(TokenKind kind) {
+      for (auto next = tokens.kind(); next != TokenKind::eEndOfInput; next = tokens.kind()) {
+        advance();
+        if (next == kind) {
+          break;
+        }
+      }
     }
   };
 
-  std::unique_ptr<IdentifierExpr> parse_simple_identifier_expression(token_iterator &tok);
+  ParseResult<IdentifierExpr> parse_simple_identifier_expression(parse_context &ctx);
 
-  std::unique_ptr<IdentifierSeq> parse_identifier_sequence(token_iterator &tok);
+  ParseResult<IdentifierSeq> parse_identifier_sequence(parse_context &ctx);
 
-  std::unique_ptr<FunctionCallExpr> parse_function_call_expression(
-    parse_context &ctx, std::unique_ptr<Expr> &&callee);
+  ParseResult<FunctionCallExpr> parse_function_call_expression(
+    parse_context &ctx, Expr *callee);
 
-  std::unique_ptr<ExpressionSequence> parse_expression_sequence(parse_context &ctx);
+  ParseResult<Expr> parse_expression(parse_context &ctx);
 
-  class Parser {
-    std::string stdlib_path_;
-    //    robin_hood::unordered_map<std::string, ASTNode *> mod_map_;
+  ExpressionSequence *parse_expression_sequence(parse_context &ctx);
 
+  class Parser {
   public:
-    explicit Parser(std::string stdlib_path)
-      : stdlib_path_{std::move(stdlib_path)} {
-    }
+    /// Tree of a parse, or every diagnostic found along the way
+    using Result = Expected<AST, Diagnostics>;
 
+    /// Parses into `ctx.ast`, without setting its root
     template <typename RootNodeType = ProgramDecl>
-    std::unique_ptr<ASTNode> parse(
-      std::vector<Token> const &tokens, std::string const &id = "main");
+    ASTNode *parse(parse_context &ctx, Symbol id = intern("main"));
 
-  private:
-    //    std::unique_ptr<Expr> parse_module_access_expr(
-    //      std::vector<Token>::const_iterator tok, IdentifierExpr const &expr);
+    template <typename RootNodeType = ProgramDecl>
+    Result parse(std::vector<Token> const &tokens, Symbol id = intern("main")) {
+      auto ctx  = parse_context{tokens};
+      auto root = parse<RootNodeType>(ctx, id);
+      return finish(root, Diagnostics{}, ctx);
+    }
 
-    //
-    //    std::unique_ptr<ASTNode> parse_module_open_stmt(ParseState &state,
-    //      std::vector<Token>::const_iterator &tok, std::vector<Token> const &tokens);
-    //
-    //    std::unique_ptr<ExternDecl> parse_extern_decl(ParseState &state,
-    //      std::vector<Token>::const_iterator tok, std::vector<Token> const &tokens);
+    template <typename RootNodeType = ProgramDecl>
+    Result parse(TokenBuffer const &tokens, Symbol id = intern("main")) {
+      auto ctx  = parse_context{tokens};
+      auto root = parse<RootNodeType>(ctx, id);
+      return finish(root, Diagnostics{}, ctx);
+    }
 
-    std::unique_ptr<FunctionDef> parse_function_def(
-      std::vector<Token>::const_iterator &tok);
+    /// Parses while lexing, without materializing the full token sequence
+    ///
+    /// Lexical errors are part of the result along with syntax errors.
+    template <typename RootNodeType = ProgramDecl>
+    Result parse(Lexer &lexer, Symbol id = intern("main")) {
+      auto ctx  = parse_context{lexer};
+      auto root = parse<RootNodeType>(ctx, id);
+      return finish(root, Diagnostics{lexer.diagnostics()}, ctx);
+    }
 
-    std::unique_ptr<FunctionBody> parse_function_body(
-      std::vector<Token>::const_iterator &tok);
+  private:
+    static Result finish(ASTNode *root, Diagnostics diagnostics, parse_context &ctx) {
+      diagnostics.append(std::move(ctx.diagnostics));
+      if (not diagnostics.empty()) {
+        return Unexpected{std::move(diagnostics)};
+      }
+      ctx.ast.set_root(root);
+      return std::move(ctx.ast);
+    }
   };
 
 } // namespace claire::parser
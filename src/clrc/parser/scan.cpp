@@ -0,0 +1,386 @@
+#include "scan.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+#include "unicode.hpp"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define CLAIRE_SCAN_X86 1
+#endif
+
+namespace claire::parser {
+
+  namespace {
+
+    //---------------------------------------------------------------------------------------
+    // Byte classes
+    //---------------------------------------------------------------------------------------
+
+    struct Numeral {
+      static bool scalar(unsigned char ch) {
+        return static_cast<unsigned>(ch - '0') < 10;
+      }
+    };
+
+    struct Identifier {
+      static bool scalar(unsigned char ch) {
+        auto lower = static_cast<unsigned char>(ch | 0x20);
+        return Numeral::scalar(ch) or static_cast<unsigned>(lower - 'a') < 26 or ch == '_';
+      }
+    };
+
+    struct String {
+      static bool scalar(unsigned char ch) {
+        return ch != '"' and ch != '\n' and ch != '\0';
+      }
+    };
+
+    struct Layout {
+      static bool scalar(unsigned char ch) {
+        return ch == ' ' or ch == '\t' or ch == '\r';
+      }
+    };
+
+    struct Comment {
+      static bool scalar(unsigned char ch) {
+        return ch != '\n' and ch != '\0';
+      }
+    };
+
+    template <typename Class>
+    std::size_t run_scalar(char const *src_ptr) {
+      std::size_t len = 0;
+      while (Class::scalar(static_cast<unsigned char>(src_ptr[len]))) {
+        ++len;
+      }
+      return len;
+    }
+
+#ifdef CLAIRE_SCAN_X86
+
+    //---------------------------------------------------------------------------------------
+    // SSE2
+    //---------------------------------------------------------------------------------------
+
+    // True (0xff) for bytes in [lo, hi]
+    inline __m128i in_range(__m128i v, char lo, char hi) {
+      auto offset = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+      return _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(hi - lo)), offset);
+    }
+
+    inline __m128i is(__m128i v, char ch) {
+      return _mm_cmpeq_epi8(v, _mm_set1_epi8(ch));
+    }
+
+    struct Sse2 {
+      static __m128i identifier(__m128i v) {
+        auto lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+        return _mm_or_si128(_mm_or_si128(in_range(v, '0', '9'), in_range(lower, 'a', 'z')),
+          is(v, '_'));
+      }
+
+      static __m128i numeral(__m128i v) {
+        return in_range(v, '0', '9');
+      }
+
+      static __m128i string(__m128i v) {
+        auto stop = _mm_or_si128(_mm_or_si128(is(v, '"'), is(v, '\n')), is(v, '\0'));
+        return _mm_xor_si128(stop, _mm_set1_epi8(-1));
+      }
+
+      static __m128i layout(__m128i v) {
+        return _mm_or_si128(_mm_or_si128(is(v, ' '), is(v, '\t')), is(v, '\r'));
+      }
+
+      static __m128i comment(__m128i v) {
+        auto stop = _mm_or_si128(is(v, '\n'), is(v, '\0'));
+        return _mm_xor_si128(stop, _mm_set1_epi8(-1));
+      }
+    };
+
+    template <__m128i (*InClass)(__m128i)>
+    std::size_t run_sse2(char const *src_ptr) {
+      constexpr std::size_t width = 16;
+
+      auto addr = reinterpret_cast<std::uintptr_t>(src_ptr);
+      auto skew = addr % width;
+      auto blk  = reinterpret_cast<__m128i const *>(addr - skew);
+
+      // Bits set for bytes outside of the class, ignoring those before `src_ptr`
+      std::uint32_t stop = ~_mm_movemask_epi8(InClass(_mm_load_si128(blk))) & 0xffffu;
+      if ((stop >>= skew)) {
+        return __builtin_ctz(stop);
+      }
+
+      for (std::size_t len = width - skew;; len += width) {
+        stop = ~_mm_movemask_epi8(InClass(_mm_load_si128(++blk))) & 0xffffu;
+        if (stop) {
+          return len + __builtin_ctz(stop);
+        }
+      }
+    }
+
+    //---------------------------------------------------------------------------------------
+    // AVX2
+    //---------------------------------------------------------------------------------------
+
+#define CLAIRE_AVX2 __attribute__((target("avx2"), always_inline)) inline
+
+    CLAIRE_AVX2 __m256i in_range(__m256i v, char lo, char hi) {
+      auto offset = _mm256_sub_epi8(v, _mm256_set1_epi8(lo));
+      return _mm256_cmpeq_epi8(_mm256_min_epu8(offset, _mm256_set1_epi8(hi - lo)), offset);
+    }
+
+    CLAIRE_AVX2 __m256i is(__m256i v, char ch) {
+      return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(ch));
+    }
+
+    struct Avx2 {
+      CLAIRE_AVX2 static __m256i identifier(__m256i v) {
+        auto lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+        return _mm256_or_si256(
+          _mm256_or_si256(in_range(v, '0', '9'), in_range(lower, 'a', 'z')), is(v, '_'));
+      }
+
+      CLAIRE_AVX2 static __m256i numeral(__m256i v) {
+        return in_range(v, '0', '9');
+      }
+
+      CLAIRE_AVX2 static __m256i string(__m256i v) {
+        auto stop = _mm256_or_si256(_mm256_or_si256(is(v, '"'), is(v, '\n')), is(v, '\0'));
+        return _mm256_xor_si256(stop, _mm256_set1_epi8(-1));
+      }
+
+      CLAIRE_AVX2 static __m256i layout(__m256i v) {
+        return _mm256_or_si256(_mm256_or_si256(is(v, ' '), is(v, '\t')), is(v, '\r'));
+      }
+
+      CLAIRE_AVX2 static __m256i comment(__m256i v) {
+        auto stop = _mm256_or_si256(is(v, '\n'), is(v, '\0'));
+        return _mm256_xor_si256(stop, _mm256_set1_epi8(-1));
+      }
+    };
+
+    template <__m256i (*InClass)(__m256i)>
+    __attribute__((target("avx2"))) std::size_t run_avx2(char const *src_ptr) {
+      constexpr std::size_t width = 32;
+
+      auto addr = reinterpret_cast<std::uintptr_t>(src_ptr);
+      auto skew = addr % width;
+      auto blk  = reinterpret_cast<__m256i const *>(addr - skew);
+
+      // Bits set for bytes outside of the class, ignoring those before `src_ptr`
+      auto stop = ~static_cast<std::uint32_t>(
+        _mm256_movemask_epi8(InClass(_mm256_load_si256(blk))));
+      if ((stop >>= skew)) {
+        return __builtin_ctz(stop);
+      }
+
+      for (std::size_t len = width - skew;; len += width) {
+        stop = ~static_cast<std::uint32_t>(
+          _mm256_movemask_epi8(InClass(_mm256_load_si256(++blk))));
+        if (stop) {
+          return len + __builtin_ctz(stop);
+        }
+      }
+    }
+
+    //---------------------------------------------------------------------------------------
+    // AVX2 UTF-8 validation
+    //---------------------------------------------------------------------------------------
+
+    // Errors a pair of consecutive bytes can make, after Keiser and Lemire, "Validating
+    // UTF-8 In Less Than One Instruction Per Byte". Each pair is looked up by the high and
+    // low nibble of its first byte and the high nibble of its second, and is erroneous if
+    // all three lookups agree on some error.
+    namespace utf8 {
+      constexpr int too_short      = 1 << 0; // 11______ 0_______, 11______ 11______
+      constexpr int too_long       = 1 << 1; // 0_______ 10______
+      constexpr int overlong_3     = 1 << 2; // 11100000 100_____
+      constexpr int too_large      = 1 << 3; // 11110100 1001____, 11110100 101_____
+      constexpr int surrogate      = 1 << 4; // 11101101 101_____
+      constexpr int overlong_2     = 1 << 5; // 1100000_ 10______
+      constexpr int too_large_1000 = 1 << 6; // 11110101+ 1000____
+      constexpr int overlong_4     = 1 << 6; // 11110000 1000____
+      constexpr int two_conts      = 1 << 7; // 10______ 10______
+      constexpr int carry          = too_short | too_long | two_conts;
+    } // namespace utf8
+
+    template <typename... Bytes>
+    CLAIRE_AVX2 __m256i lookup16(__m256i nibbles, Bytes... table) {
+      static_assert(sizeof...(table) == 16);
+      return _mm256_shuffle_epi8(
+        _mm256_broadcastsi128_si256(_mm_setr_epi8(static_cast<char>(table)...)), nibbles);
+    }
+
+    CLAIRE_AVX2 __m256i high_nibbles(__m256i v) {
+      return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0f));
+    }
+
+    // Bytes of `v` shifted up by N, shifting in the last bytes of `prev`
+    template <int N>
+    CLAIRE_AVX2 __m256i shift_in(__m256i v, __m256i prev) {
+      return _mm256_alignr_epi8(v, _mm256_permute2x128_si256(prev, v, 0x21), 16 - N);
+    }
+
+    // Non-zero bytes for every error ending in `v`, given the block preceding it
+    CLAIRE_AVX2 __m256i utf8_errors(__m256i v, __m256i prev) {
+      using namespace utf8;
+
+      auto prev1       = shift_in<1>(v, prev);
+      auto byte_1_high = lookup16(high_nibbles(prev1),
+        // 0_______ ________
+        too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+        // 10______ ________
+        two_conts, two_conts, two_conts, two_conts,
+        // 1100____ ________
+        too_short | overlong_2,
+        // 1101____ ________
+        too_short,
+        // 1110____ ________
+        too_short | overlong_3 | surrogate,
+        // 1111____ ________
+        too_short | too_large | too_large_1000 | overlong_4);
+
+      auto byte_1_low = lookup16(_mm256_and_si256(prev1, _mm256_set1_epi8(0x0f)),
+        // ____0000 ________
+        carry | overlong_3 | overlong_2 | overlong_4,
+        // ____0001 ________
+        carry | overlong_2,
+        // ____001_ ________
+        carry, carry,
+        // ____0100 ________
+        carry | too_large,
+        // ____0101 ________ to ____1100 ________
+        carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+        // ____1101 ________
+        carry | too_large | too_large_1000 | surrogate,
+        // ____111_ ________
+        carry | too_large | too_large_1000, carry | too_large | too_large_1000);
+
+      auto byte_2_high = lookup16(high_nibbles(v),
+        // ________ 0_______
+        too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+        too_short,
+        // ________ 1000____
+        too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+        // ________ 1001____
+        too_long | overlong_2 | two_conts | overlong_3 | too_large,
+        // ________ 101_____
+        too_long | overlong_2 | two_conts | surrogate | too_large,
+        too_long | overlong_2 | two_conts | surrogate | too_large,
+        // ________ 11______
+        too_short, too_short, too_short, too_short);
+
+      auto special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+      // Third and fourth bytes of a sequence must be continuations, while two_conts above
+      // flags every pair of continuations
+      auto third  = _mm256_subs_epu8(shift_in<2>(v, prev), _mm256_set1_epi8(0xe0 - 0x80));
+      auto fourth = _mm256_subs_epu8(shift_in<3>(v, prev), _mm256_set1_epi8(0xf0 - 0x80));
+      auto must23 = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(-0x80));
+      return _mm256_xor_si256(must23, special);
+    }
+
+    // Non-zero bytes if `v` ends within a multi-byte sequence
+    CLAIRE_AVX2 __m256i utf8_incomplete(__m256i v) {
+      auto max = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, static_cast<char>(0xf0 - 1),
+        static_cast<char>(0xe0 - 1), static_cast<char>(0xc0 - 1));
+      return _mm256_subs_epu8(v, max);
+    }
+
+    // Pinpoints the first error of a block known to have one, starting from the last
+    // sequence that may have been left incomplete by the block preceding it
+    std::size_t locate_utf8_error(char const *begin, std::size_t size, std::size_t at) {
+      auto start = at;
+      for (std::size_t back = 1; back <= 3 and back <= at; ++back) {
+        auto byte = static_cast<unsigned char>(begin[at - back]);
+        if (byte >= 0xc0) {
+          start = at - back;
+        }
+        if (byte < 0x80 or byte >= 0xc0) {
+          break;
+        }
+      }
+      return start + valid_utf8_prefix(begin + start, size - start);
+    }
+
+    __attribute__((target("avx2"))) std::size_t validate_avx2(
+      char const *begin, std::size_t size) {
+      constexpr std::size_t width = 32;
+
+      auto prev       = _mm256_setzero_si256();
+      auto incomplete = _mm256_setzero_si256();
+
+      std::size_t at = 0;
+      for (; at + width <= size; at += width) {
+        auto v = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(begin + at));
+
+        // ASCII only needs to check that the previous block was not cut short
+        auto errors = _mm256_movemask_epi8(v) == 0 ? incomplete : utf8_errors(v, prev);
+        if (not _mm256_testz_si256(errors, errors)) {
+          return locate_utf8_error(begin, size, at);
+        }
+        incomplete = utf8_incomplete(v);
+        prev       = v;
+      }
+
+      // Zero padding past the end catches sequences the source is cut short in
+      alignas(width) char tail[width]{};
+      std::memcpy(tail, begin + at, size - at);
+      auto v      = _mm256_load_si256(reinterpret_cast<__m256i const *>(tail));
+      auto errors = _mm256_or_si256(utf8_errors(v, prev), incomplete);
+      if (not _mm256_testz_si256(errors, errors)) {
+        return locate_utf8_error(begin, size, at);
+      }
+      return size;
+    }
+
+#undef CLAIRE_AVX2
+
+#endif
+
+    ScanKernels select_kernels() {
+#ifdef CLAIRE_SCAN_X86
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2")) {
+        return {
+          run_avx2<Avx2::identifier>,
+          run_avx2<Avx2::numeral>,
+          run_avx2<Avx2::string>,
+          run_avx2<Avx2::layout>,
+          run_avx2<Avx2::comment>,
+          validate_avx2,
+        };
+      }
+      return {
+        run_sse2<Sse2::identifier>,
+        run_sse2<Sse2::numeral>,
+        run_sse2<Sse2::string>,
+        run_sse2<Sse2::layout>,
+        run_sse2<Sse2::comment>,
+        valid_utf8_prefix,
+      };
+#else
+      return {
+        run_scalar<Identifier>,
+        run_scalar<Numeral>,
+        run_scalar<String>,
+        run_scalar<Layout>,
+        run_scalar<Comment>,
+        valid_utf8_prefix,
+      };
+#endif
+    }
+
+  } // namespace
+
+  ScanKernels const scan = select_kernels();
+
+} // namespace claire::parser
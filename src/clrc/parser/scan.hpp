@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+
+namespace claire::parser {
+
+  /// Returns the length of the run of bytes starting at `src_ptr` that would keep the
+  /// lexer in its current state. Kernels may stop short of the true end of a run, the
+  /// table-driven loop picks up from wherever they stop.
+  using run_length_fn = std::size_t (*)(char const *src_ptr);
+
+  /// Returns the length of the longest prefix of `[begin, begin + size)` that is valid
+  /// UTF-8, i.e. `size` if all of it is.
+  using validate_fn = std::size_t (*)(char const *begin, std::size_t size);
+
+  /// Kernels to skip over runs of same-class bytes inside of the lexer DFA
+  ///
+  /// Every run ends at the NUL sentinel, so scanning never leaves the source buffer.
+  /// Vectorized kernels only issue aligned loads, which cannot cross into the page
+  /// following the sentinel.
+  struct ScanKernels {
+    // [A-Za-z0-9_]
+    run_length_fn identifier;
+    // [0-9]
+    run_length_fn numeral;
+    // Anything but '"', '\n' or NUL
+    run_length_fn string;
+    // ' ', '\t' or '\r'
+    run_length_fn layout;
+    // Anything but '\n' or NUL
+    run_length_fn comment;
+
+    // Checks a whole source before lexing it, the DFA then trusts non-ASCII bytes to
+    // form complete code points
+    validate_fn utf8;
+  };
+
+  // Kernels for the widest instruction set supported by the host CPU, selected at startup
+  extern ScanKernels const scan;
+
+} // namespace claire::parser
@@ -0,0 +1,270 @@
+#include "state_machine.hpp"
+
+#include <optional>
+
+#include "token.hpp"
+
+namespace claire::parser {
+
+  namespace {
+
+    constexpr auto num_states = utype(LexicalState::eCount);
+
+    // Reevaluates character after ending identifier, special sequence, or numeric literal,
+    // usually following negative lookahead to terminate token. The NUL sentinel is
+    // reevaluated too, so that lexing stops right at it.
+    constexpr bool reevaluates(unsigned char ch) {
+      switch (glyph_of(ch)) {
+      case Glyph::eEOF:
+      case Glyph::eLineFeed:
+      case Glyph::eLetter:
+      case Glyph::eDigit:
+      case Glyph::eSeparator:
+      case Glyph::eColon:
+      case Glyph::eHyphen:
+      case Glyph::eVerticalBar:
+      case Glyph::eUnicode:
+        return true;
+      case Glyph::eOperator:
+        return ch != '!';
+      default:
+        return false;
+      }
+    }
+
+    // True if inside of an identifier, value, or special multi-character operator
+    constexpr bool inside(LexicalState state) {
+      switch (state) {
+      case LexicalState::eSeparator:
+      case LexicalState::eOperatorSingle:
+      case LexicalState::eOperatorMulti:
+      case LexicalState::eIdentifier:
+      case LexicalState::eIdentifierUnicode:
+      case LexicalState::eNumeral:
+      case LexicalState::eNumeralExponent:
+      case LexicalState::eString:
+        return true;
+      default:
+        return false;
+      }
+    }
+
+    // State transitions that always serve to initiate a new lexeme after terminating an
+    // existing one
+    constexpr LexicalState initiate(Glyph glyph) {
+      switch (glyph) {
+      case Glyph::eLayout:
+      case Glyph::eSpace:
+        return LexicalState::eNextChar;
+      case Glyph::eLineFeed:
+        return LexicalState::eNewLine;
+      case Glyph::eLetter:
+        return LexicalState::eIdentifier;
+      case Glyph::eUnicode:
+        return LexicalState::eIdentifierUnicode;
+      case Glyph::eDigit:
+        return LexicalState::eNumeral;
+      case Glyph::eSeparator:
+        return LexicalState::eSeparator;
+      case Glyph::eOperator:
+        return LexicalState::eOperatorSingle;
+      case Glyph::eColon:
+      case Glyph::eHyphen:
+      case Glyph::eVerticalBar:
+        return LexicalState::eOperatorMulti;
+      case Glyph::eDoubleQuote:
+        return LexicalState::eString;
+      default:
+        return LexicalState::eFinal;
+      }
+    }
+
+    // TODO(rihtwis-weard): need to start treating NewLine/LineFeeds as tokens for breaking up expressions?
+
+    // Numerals swallow every letter, digit and '.' following them, like preprocessing
+    // numbers in C, and the sign of an exponent. Whether they are well-formed is up to
+    // decoding.
+    constexpr LexicalState reduce_numeral(LexicalState state, unsigned char ch) {
+      if (ch == 'e' or ch == 'E') {
+        return LexicalState::eNumeralExponent;
+      }
+      if ((ch == '+' or ch == '-') and state == LexicalState::eNumeralExponent) {
+        return LexicalState::eNumeral;
+      }
+
+      switch (glyph_of(ch)) {
+      case Glyph::eLetter:
+      case Glyph::eDigit:
+      case Glyph::eUnicode:
+        return LexicalState::eNumeral;
+      case Glyph::eDoubleQuote:
+        return LexicalState::eEOF;
+      default:
+        return ch == '.' ? LexicalState::eNumeral : LexicalState::eNumeralEnd;
+      }
+    }
+
+    // Lexical analysis state transitions, anything not handled transitions to eFinal
+    constexpr LexicalState reduce(LexicalState state, unsigned char ch) {
+      auto glyph = glyph_of(ch);
+      switch (state) {
+      case LexicalState::eNextChar:
+      case LexicalState::eNewLine:
+      case LexicalState::eIdentifierEnd:
+      case LexicalState::eStringEnd:
+      case LexicalState::eNumeralEnd:
+      case LexicalState::eSeparator:
+      case LexicalState::eOperatorSingle:
+      case LexicalState::eOperatorMultiEnd:
+        return initiate(glyph);
+
+      // The lexer consumes the rest of a non-ASCII code point itself, and carries on as
+      // in an identifier if it belongs there
+      case LexicalState::eIdentifier:
+      case LexicalState::eIdentifierUnicode:
+        switch (glyph) {
+        case Glyph::eLetter:
+        case Glyph::eDigit:
+          return LexicalState::eIdentifier;
+        case Glyph::eUnicode:
+          return LexicalState::eIdentifierUnicode;
+        default:
+          return LexicalState::eIdentifierEnd;
+        }
+
+      case LexicalState::eString:
+        switch (glyph) {
+        case Glyph::eLineFeed:
+          return LexicalState::eError;
+        case Glyph::eDoubleQuote:
+          return LexicalState::eStringEnd;
+        case Glyph::eEOF:
+          return LexicalState::eEOF;
+        default:
+          return LexicalState::eString;
+        }
+
+      case LexicalState::eNumeral:
+      case LexicalState::eNumeralExponent:
+        return reduce_numeral(state, ch);
+
+      case LexicalState::eOperatorMulti:
+        switch (glyph) {
+        case Glyph::eOperator:
+        case Glyph::eColon:
+          return LexicalState::eOperatorMulti;
+        case Glyph::eHyphen:
+        case Glyph::eVerticalBar:
+          return LexicalState::eError;
+        default:
+          return LexicalState::eOperatorMultiEnd;
+        }
+
+      default:
+        return LexicalState::eFinal;
+      }
+    }
+
+    // Token ended upon entering a state, as the lexer emits it
+    struct Acceptance {
+      // Kind given to the token, TokenKind::eCount to keep the kind of the lexeme so far
+      TokenKind kind;
+      // Offset to apply to the source pointer past the token end: -1 if the byte just read
+      // follows the token, and is reevaluated when possible, 0 if it ends the token
+      std::ptrdiff_t reeval;
+
+      constexpr bool operator==(Acceptance const &) const = default;
+    };
+
+    // States the lexer runs code of its own in (scanning runs, decoding code points,
+    // tracking line feeds, recovering from errors) accept nothing, and are never merged
+    constexpr std::optional<Acceptance> acceptance_of(LexicalState state) {
+      switch (state) {
+      case LexicalState::eIdentifierEnd:
+      case LexicalState::eOperatorMultiEnd:
+        return Acceptance{TokenKind::eCount, -1};
+      case LexicalState::eNumeralEnd:
+        return Acceptance{TokenKind::eNumeral, -1};
+      case LexicalState::eStringEnd:
+        return Acceptance{TokenKind::eCount, 0};
+      case LexicalState::eSeparator:
+        return Acceptance{TokenKind::eSeparator, 0};
+      case LexicalState::eOperatorSingle:
+        return Acceptance{TokenKind::eOperator, 0};
+      default:
+        return std::nullopt;
+      }
+    }
+
+    // Merges states accepting the same token whose transitions lead to equivalent
+    // states, by partition refinement starting from what each state accepts
+    constexpr auto minimize() {
+      // Each block is named after its smallest state, which becomes its representative
+      std::array<std::uint8_t, num_states> block{};
+      for (std::size_t s = 0; s < num_states; ++s) {
+        auto state = static_cast<LexicalState>(s);
+        block[s]   = static_cast<std::uint8_t>(s);
+        for (std::size_t t = 0; t < s; ++t) {
+          auto other = static_cast<LexicalState>(t);
+          if (acceptance_of(state) and acceptance_of(state) == acceptance_of(other) and
+              inside(state) == inside(other)) {
+            block[s] = static_cast<std::uint8_t>(t);
+            break;
+          }
+        }
+      }
+
+      // Splits blocks until states in the same block transition to the same blocks on
+      // every byte
+      for (bool refined = true; refined;) {
+        refined = false;
+
+        std::array<std::uint8_t, num_states> next{};
+        for (std::size_t s = 0; s < num_states; ++s) {
+          next[s] = static_cast<std::uint8_t>(s);
+          for (std::size_t t = 0; t < s; ++t) {
+            bool same = block[s] == block[t];
+            for (std::size_t ch = 0; same and ch < 256; ++ch) {
+              auto byte = static_cast<unsigned char>(ch);
+              same      = block[utype(reduce(static_cast<LexicalState>(s), byte))] ==
+                     block[utype(reduce(static_cast<LexicalState>(t), byte))];
+            }
+            if (same) {
+              next[s] = next[t];
+              break;
+            }
+          }
+          refined |= next[s] != block[s];
+        }
+        block = next;
+      }
+
+      std::array<LexicalState, num_states> representative{};
+      for (std::size_t s = 0; s < num_states; ++s) {
+        representative[s] = static_cast<LexicalState>(block[s]);
+      }
+      return representative;
+    }
+
+    constexpr auto representative = minimize();
+
+    // Fuses equivalence classes, transitions, lexeme membership and reevaluation into a
+    // single lookup per source byte
+    constexpr LexTable make_lex_table() {
+      LexTable table{};
+      for (std::size_t s = 0; s < num_states; ++s) {
+        for (std::size_t ch = 0; ch < 256; ++ch) {
+          auto byte = static_cast<unsigned char>(ch);
+          auto next =
+            representative[utype(reduce(static_cast<LexicalState>(s), byte))];
+          table[s][ch] = LexTransition{next, inside(next), reevaluates(byte)};
+        }
+      }
+      return table;
+    }
+
+  } // namespace
+
+  constinit LexTable const lex_table = make_lex_table();
+
+} // namespace claire::parser
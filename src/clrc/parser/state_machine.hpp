@@ -0,0 +1,158 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "../utils.hpp"
+
+namespace claire::parser {
+
+  enum class Glyph {
+    eLayout,
+    eSpace,
+    eCarriageReturn,
+    eLineFeed,
+    eLetter,
+    eDigit,
+    eSeparator,
+    eOperator,
+    eColon,
+    eHyphen,
+    eVerticalBar,
+    eDoubleQuote,
+    // Any byte of a multi-byte UTF-8 sequence
+    eUnicode,
+    eEOF,
+    eCount
+  };
+
+  // Character equivalence classes
+  constexpr Glyph glyph_of(unsigned char ch) {
+    switch (ch) {
+    // Layout
+    case '\0':
+      return Glyph::eEOF;
+    case '\n':
+      return Glyph::eLineFeed;
+    case ' ':
+      return Glyph::eSpace;
+    // String Literals
+    case '"':
+      return Glyph::eDoubleQuote;
+    // Special
+    case '!':
+    case '(':
+    case ')':
+    case '+':
+    case '.':
+    case '<':
+    case '=':
+    case '>':
+      return Glyph::eOperator;
+    case '-':
+      return Glyph::eHyphen;
+    case ':':
+      return Glyph::eColon;
+    case ';':
+    case '\\':
+    case '{':
+    case '}':
+      return Glyph::eSeparator;
+    case '|':
+      return Glyph::eVerticalBar;
+    default:
+      break;
+    }
+
+    if (ch >= '0' and ch <= '9') {
+      return Glyph::eDigit;
+    }
+    if ((ch >= 'A' and ch <= 'Z') or (ch >= 'a' and ch <= 'z') or ch == '_') {
+      return Glyph::eLetter;
+    }
+    if (ch >= 0x80) {
+      return Glyph::eUnicode;
+    }
+    return Glyph::eLayout;
+  }
+
+  enum class LexicalState : std::uint8_t {
+    eFinal,
+    eNextChar,
+    eSeparator,
+    eOperatorSingle,
+    eOperatorMulti,
+    eOperatorMultiEnd,
+    eIdentifier,
+    eIdentifierEnd,
+    // Non-ASCII code point, which may start or continue an identifier
+    eIdentifierUnicode,
+    eNumeral,
+    eNumeralExponent,
+    eNumeralEnd,
+    eString,
+    eStringEnd,
+    eComment,
+    eNewLine,
+    eEOF,
+    eError,
+    eCount,
+  };
+
+  /// Entry of the fused transition table, packed into a single byte
+  ///
+  ///   bits 0-4  next lexical state
+  ///   bit  5    next state is inside of a lexeme
+  ///   bit  6    byte is reevaluated if it ends a lexeme
+  class LexTransition {
+    static constexpr std::uint8_t state_mask = 0x1f;
+    static constexpr std::uint8_t inside_bit = 0x20;
+    static constexpr std::uint8_t reeval_bit = 0x40;
+
+    std::uint8_t packed_;
+
+  public:
+    constexpr LexTransition()
+      : packed_{0} {
+    }
+
+    constexpr LexTransition(LexicalState next, bool inside, bool reeval)
+      : packed_{static_cast<std::uint8_t>(
+          utype(next) | (inside ? inside_bit : 0) | (reeval ? reeval_bit : 0))} {
+    }
+
+    [[nodiscard]] constexpr LexicalState next() const {
+      return static_cast<LexicalState>(packed_ & state_mask);
+    }
+
+    /// \return 1 if the next state is inside of a lexeme, 0 otherwise
+    [[nodiscard]] constexpr std::size_t inside() const {
+      return (packed_ & inside_bit) >> 5;
+    }
+
+    /// \return offset to apply to the source pointer to reevaluate the current byte
+    [[nodiscard]] constexpr std::ptrdiff_t reeval() const {
+      return -static_cast<std::ptrdiff_t>((packed_ & reeval_bit) >> 6);
+    }
+  };
+
+  static_assert(utype(LexicalState::eCount) <= 32, "lexical states must fit in 5 bits");
+
+  using LexTable = std::array<std::array<LexTransition, 256>, utype(LexicalState::eCount)>;
+
+  // Lexical state transitions, indexed by current state and source byte
+  extern LexTable const lex_table;
+
+  // Apply state transition using current state and source byte
+  inline auto transition(LexicalState curr, unsigned char ch) {
+    return lex_table[utype(curr)][ch];
+  }
+
+  inline auto should_exit(LexicalState curr) {
+    // Since LexicalState::eFinal is 0, by default we break out when
+    // state transitions are not explicitly handled
+    return utype(curr) <= utype(LexicalState::eFinal);
+  }
+
+} // namespace claire::parser
@@ -0,0 +1,322 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iomanip>
+#include <optional>
+#include <string_view>
+
+#include "../source_loc.hpp"
+#include "../symbol.hpp"
+#include "../utils.hpp"
+#include "numeral.hpp"
+
+namespace claire::parser {
+
+  enum class TokenKind : std::uint8_t {
+    // General Tokens
+    eIdentifier,
+    eStringLiteral,
+    eNumeral,
+    eSeparator,
+    eOperator,
+
+    // Special Operators
+    eAccessMember,
+    eLParens,
+    eRParens,
+    eMinus,
+    ePlus,
+    eLess,
+    eGreater,
+    eAssign,
+    eColon,
+    eScopeBegin,
+    eScopeEnd,
+    eSemicolon,
+    eBackslash,
+
+    // Multi
+    eAccessNamespace,
+    eArrow,
+    ePipe,
+
+    // Reserved Keywords
+    eReservedFunc,
+    eReservedLet,
+    eReservedIf,
+    eReservedElse,
+    eReservedOpen,
+    eReservedModule,
+    eReservedExport,
+    eReservedExtern,
+    eReservedWhen,
+
+    // Builtin Types
+    eTypeBinary,
+    eTypeU32,
+
+    // Malformed lexeme, along with a diagnostic reported by the lexer
+    eError,
+
+    // Past the last token of a stream, never produced by the lexer
+    eEndOfInput,
+
+    eCount,
+  };
+
+  struct TokenSpelling {
+    std::string_view repr;
+    TokenKind        kind;
+  };
+
+  // Spellings that refine a general token kind into a more specific one
+  inline constexpr TokenSpelling token_spellings[] = {
+    // Operators
+    {".", TokenKind::eAccessMember},
+    {"(", TokenKind::eLParens},
+    {")", TokenKind::eRParens},
+    {"-", TokenKind::eMinus},
+    {"+", TokenKind::ePlus},
+    {"<", TokenKind::eLess},
+    {">", TokenKind::eGreater},
+    {"=", TokenKind::eAssign},
+    {":", TokenKind::eColon},
+    {"{", TokenKind::eScopeBegin},
+    {"}", TokenKind::eScopeEnd},
+    {";", TokenKind::eSemicolon},
+    {"\\", TokenKind::eBackslash},
+    // Special Multi Operators
+    {"::", TokenKind::eAccessNamespace},
+    {"->", TokenKind::eArrow},
+    {"|>", TokenKind::ePipe},
+    // Reserved Keywords
+    {"func", TokenKind::eReservedFunc},
+    {"let", TokenKind::eReservedLet},
+    {"if", TokenKind::eReservedIf},
+    {"else", TokenKind::eReservedElse},
+    {"open", TokenKind::eReservedOpen},
+    {"module", TokenKind::eReservedModule},
+    {"export", TokenKind::eReservedExport},
+    {"extern", TokenKind::eReservedExtern},
+    {"when", TokenKind::eReservedWhen},
+    // Builtin Types
+    {"binary", TokenKind::eTypeBinary},
+    {"u32", TokenKind::eTypeU32},
+  };
+
+  /// Perfect hash over `token_spellings`, generated at compile time
+  ///
+  /// Spellings are hashed from their length and their first, middle and last
+  /// characters. The multipliers are searched for at compile time until every
+  /// spelling lands in its own slot, so a lookup is one hash, one length check and
+  /// one short compare, without allocating or calling a general-purpose hash.
+  class SpellingTable {
+    static constexpr std::size_t   bits           = 6;
+    static constexpr std::size_t   size           = std::size_t{1} << bits;
+    static constexpr std::uint32_t max_multiplier = 256;
+
+    std::uint32_t                   mul_first_  = 0;
+    std::uint32_t                   mul_middle_ = 0;
+    std::array<TokenSpelling, size> slots_{};
+
+  public:
+    constexpr SpellingTable() {
+      for (std::uint32_t a = 1; a < max_multiplier; ++a) {
+        for (std::uint32_t b = 1; b < max_multiplier; ++b) {
+          if (try_build(a, b)) {
+            return;
+          }
+        }
+      }
+    }
+
+    [[nodiscard]] constexpr bool is_perfect() const {
+      return mul_first_ != 0;
+    }
+
+    [[nodiscard]] constexpr std::optional<TokenKind> find(
+      char const *ptr, std::size_t len) const {
+      if (len == 0) {
+        return std::nullopt;
+      }
+
+      auto const &slot = slots_[hash(mul_first_, mul_middle_, ptr, len)];
+      if (slot.repr == std::string_view{ptr, len}) {
+        return slot.kind;
+      }
+      return std::nullopt;
+    }
+
+  private:
+    static constexpr std::size_t hash(
+      std::uint32_t a, std::uint32_t b, char const *ptr, std::size_t len) {
+      auto first  = static_cast<std::uint32_t>(static_cast<unsigned char>(ptr[0]));
+      auto middle = static_cast<std::uint32_t>(static_cast<unsigned char>(ptr[len / 2]));
+      auto last   = static_cast<std::uint32_t>(static_cast<unsigned char>(ptr[len - 1]));
+      auto mixed  = (first * a + middle * b + last + static_cast<std::uint32_t>(len)) *
+                   std::uint32_t{0x9e3779b1};
+      return mixed >> (32 - bits);
+    }
+
+    constexpr bool try_build(std::uint32_t a, std::uint32_t b) {
+      slots_ = {};
+      for (auto const &spelling : token_spellings) {
+        auto &slot = slots_[hash(a, b, spelling.repr.data(), spelling.repr.size())];
+        if (not slot.repr.empty()) {
+          return false;
+        }
+        slot = spelling;
+      }
+      mul_first_  = a;
+      mul_middle_ = b;
+      return true;
+    }
+  };
+
+  inline constexpr SpellingTable spelling_table{};
+
+  static_assert(spelling_table.is_perfect(), "no collision-free multipliers for spellings");
+
+  /// \return spelling of a token kind refined from a general one, empty for any other
+  constexpr std::string_view spelling_of(TokenKind kind) {
+    for (auto const &spelling : token_spellings) {
+      if (spelling.kind == kind) {
+        return spelling.repr;
+      }
+    }
+    return {};
+  }
+
+  struct Token {
+    // Members are ordered so that the payloads fill the padding ahead of `repr`
+    TokenKind        kind;
+    // Decoded value of numerals, none for any other kind
+    NumeralValue     value;
+    // Interned spelling of identifiers, empty for any other kind
+    Symbol           symbol;
+    std::string_view repr;
+    SourceLoc        loc;
+
+    Token() = default;
+
+    Token(TokenKind kind, std::string_view repr, Symbol symbol, NumeralValue value = {},
+      SourceLoc loc = {})
+      : kind{kind}
+      , value{value}
+      , symbol{symbol}
+      , repr{repr}
+      , loc{loc} {
+    }
+
+    /// Token made outside of the lexer, interning its spelling if it is an identifier
+    /// and decoding it if it is a numeral
+    Token(TokenKind kind, std::string_view repr)
+      : Token{kind, repr, kind == TokenKind::eIdentifier ? intern(repr) : Symbol{},
+          kind == TokenKind::eNumeral ? decode_numeral(repr).value_or(NumeralValue{})
+                                      : NumeralValue{}} {
+    }
+
+    friend bool operator==(Token const &lhs, Token const &rhs) = default;
+
+    friend std::ostream &operator<<(std::ostream &os, Token const &tok);
+  };
+
+  // Kind, value and symbol pack into the 16 bytes ahead of `repr`. The location past it
+  // takes 4 bytes, and alignment pads the token from 36 to 40 bytes.
+  static_assert(sizeof(Token) == 5 * sizeof(std::uint64_t), "token payloads must pack");
+
+  struct Lexeme {
+    TokenKind        kind;
+    std::string_view repr;
+    std::size_t      len;
+    Symbol           symbol;
+    NumeralValue     value;
+
+  public:
+    auto to_hyponym() {
+      if (auto token_kind = spelling_table.find(repr.data(), repr.size())) {
+        kind = *token_kind;
+      }
+    }
+
+    auto to_hyponym(TokenKind fallback) {
+      kind = spelling_table.find(repr.data(), repr.size()).value_or(fallback);
+    }
+
+    auto update_repr(char const *src_ptr, int start_offset, int end_offset) {
+      // View into the source buffer, no allocation per lexeme
+      auto start = src_ptr - (len + start_offset);
+      repr       = std::string_view{start, len + end_offset};
+    }
+
+    auto intern() {
+      if (kind == TokenKind::eIdentifier) {
+        symbol = claire::intern(repr);
+      }
+    }
+
+    auto reset() {
+      // Reset trackers for next token
+      len    = 0;
+      symbol = {};
+      value  = {};
+    }
+
+    auto as_token(SourceLoc loc) {
+      return Token{kind, repr, symbol, value, loc};
+    }
+  };
+
+#define TOKEN_DESC(kind, desc)                                                           \
+  case (kind):                                                                           \
+    os << (desc);                                                                        \
+    break
+
+  inline std::ostream &operator<<(std::ostream &os, Token const &tok) {
+    os << std::setw(12);
+
+    switch (tok.kind) {
+      TOKEN_DESC(TokenKind::eIdentifier, "Identifier");
+      TOKEN_DESC(TokenKind::eStringLiteral, "String");
+      TOKEN_DESC(TokenKind::eNumeral, "Numeral");
+      TOKEN_DESC(TokenKind::eSeparator, "Separator");
+      TOKEN_DESC(TokenKind::eOperator, "Operator");
+      TOKEN_DESC(TokenKind::eAccessMember, "Operator");
+      TOKEN_DESC(TokenKind::eLParens, "Operator");
+      TOKEN_DESC(TokenKind::eRParens, "Operator");
+      TOKEN_DESC(TokenKind::eMinus, "Operator");
+      TOKEN_DESC(TokenKind::ePlus, "Operator");
+      TOKEN_DESC(TokenKind::eLess, "Operator");
+      TOKEN_DESC(TokenKind::eGreater, "Operator");
+      TOKEN_DESC(TokenKind::eAssign, "Operator");
+      TOKEN_DESC(TokenKind::eColon, "Operator");
+      TOKEN_DESC(TokenKind::eScopeBegin, "Separator");
+      TOKEN_DESC(TokenKind::eScopeEnd, "Separator");
+      TOKEN_DESC(TokenKind::eSemicolon, "Separator");
+      TOKEN_DESC(TokenKind::eBackslash, "Separator");
+      TOKEN_DESC(TokenKind::eAccessNamespace, "Operator");
+      TOKEN_DESC(TokenKind::eArrow, "Operator");
+      TOKEN_DESC(TokenKind::ePipe, "Operator");
+
+      TOKEN_DESC(TokenKind::eReservedFunc, "Keyword");
+      TOKEN_DESC(TokenKind::eReservedLet, "Keyword");
+      TOKEN_DESC(TokenKind::eReservedIf, "Keyword");
+      TOKEN_DESC(TokenKind::eReservedElse, "Keyword");
+      TOKEN_DESC(TokenKind::eReservedOpen, "Keyword");
+      TOKEN_DESC(TokenKind::eReservedModule, "Keyword");
+      TOKEN_DESC(TokenKind::eReservedExport, "Keyword");
+      TOKEN_DESC(TokenKind::eReservedExtern, "Keyword");
+      TOKEN_DESC(TokenKind::eReservedWhen, "Keyword");
+      TOKEN_DESC(TokenKind::eTypeBinary, "Type");
+      TOKEN_DESC(TokenKind::eTypeU32, "Type");
+      TOKEN_DESC(TokenKind::eError, "Error");
+    default:
+      os << "Unknown";
+      break;
+    }
+
+    return os << " | " << tok.repr << " |";
+  }
+
+} // namespace claire::parser
@@ -0,0 +1,28 @@
+#include "token_buffer.hpp"
+
+#include <cassert>
+#include <limits>
+
+namespace claire::parser {
+
+  TokenBuffer::TokenBuffer(char const *base, SourceLoc base_loc)
+    : base_{base}
+    , base_loc_{base_loc} {
+  }
+
+  void TokenBuffer::reserve(std::size_t size) {
+    kinds_.reserve(size);
+    offsets_.reserve(size);
+    lengths_.reserve(size);
+    payloads_.reserve(size);
+  }
+
+  void TokenBuffer::push_back(Token const &tok) {
+    // Lexers reject sources too large for 32-bit offsets
+    assert(static_cast<std::size_t>(tok.repr.data() + tok.repr.size() - base_) <=
+           std::numeric_limits<std::uint32_t>::max());
+    push_back(tok.kind, static_cast<std::uint32_t>(tok.repr.data() - base_),
+      static_cast<std::uint32_t>(tok.repr.size()), tok.symbol, tok.value);
+  }
+
+} // namespace claire::parser
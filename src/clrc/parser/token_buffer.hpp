@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "token.hpp"
+
+namespace claire::parser {
+
+  /// Tokens stored as parallel arrays of kinds, 32-bit spans into a text buffer and
+  /// payloads
+  ///
+  /// Each token costs 13 bytes, and the parser's kind checks walk a dense array of
+  /// single-byte kinds instead of striding over whole `Token`s. Numerals take another
+  /// 9 bytes for their value, in a side table. Locations come for free from the
+  /// offsets, as lexed tokens all lie within one source, which is never as large as
+  /// 4 GiB.
+  class TokenBuffer {
+    char const                *base_;
+    SourceLoc                  base_loc_;
+    std::vector<TokenKind>     kinds_;
+    std::vector<std::uint32_t> offsets_;
+    std::vector<std::uint32_t> lengths_;
+    // Symbol id of identifiers, index into `numerals_` of numerals
+    std::vector<std::uint32_t> payloads_;
+    std::vector<NumeralValue>  numerals_;
+
+  public:
+    /// \param base start of the text all pushed tokens are views into
+    /// \param base_loc location of `base`, if it is part of a `Source`
+    explicit TokenBuffer(char const *base, SourceLoc base_loc = {});
+
+    TokenBuffer(TokenBuffer const &) = delete;
+    TokenBuffer &operator=(TokenBuffer const &) = delete;
+
+    TokenBuffer(TokenBuffer &&) = default;
+    TokenBuffer &operator=(TokenBuffer &&) = default;
+
+    void reserve(std::size_t size);
+
+    /// \param tok token whose text lies within the buffer starting at `base`
+    void push_back(Token const &tok);
+
+    void push_back(TokenKind kind, std::uint32_t offset, std::uint32_t length,
+      Symbol symbol = {}, NumeralValue value = {}) {
+      kinds_.push_back(kind);
+      offsets_.push_back(offset);
+      lengths_.push_back(length);
+      if (kind == TokenKind::eNumeral) {
+        payloads_.push_back(static_cast<std::uint32_t>(numerals_.size()));
+        numerals_.push_back(value);
+      } else {
+        payloads_.push_back(symbol.id());
+      }
+    }
+
+    [[nodiscard]] std::size_t size() const {
+      return kinds_.size();
+    }
+
+    [[nodiscard]] bool empty() const {
+      return kinds_.empty();
+    }
+
+    [[nodiscard]] std::span<TokenKind const> kinds() const {
+      return kinds_;
+    }
+
+    [[nodiscard]] TokenKind kind(std::size_t i) const {
+      return kinds_[i];
+    }
+
+    [[nodiscard]] std::uint32_t offset(std::size_t i) const {
+      return offsets_[i];
+    }
+
+    [[nodiscard]] std::uint32_t length(std::size_t i) const {
+      return lengths_[i];
+    }
+
+    /// \return offset one past the end of the i-th token
+    [[nodiscard]] std::uint32_t end(std::size_t i) const {
+      return offsets_[i] + lengths_[i];
+    }
+
+    [[nodiscard]] std::string_view repr(std::size_t i) const {
+      return {base_ + offsets_[i], lengths_[i]};
+    }
+
+    [[nodiscard]] Symbol symbol(std::size_t i) const {
+      return kinds_[i] == TokenKind::eNumeral ? Symbol{} : Symbol{payloads_[i]};
+    }
+
+    [[nodiscard]] NumeralValue value(std::size_t i) const {
+      return kinds_[i] == TokenKind::eNumeral ? numerals_[payloads_[i]] : NumeralValue{};
+    }
+
+    [[nodiscard]] SourceLoc loc(std::size_t i) const {
+      return base_loc_.valid() ? SourceLoc{base_loc_.offset() + offsets_[i]} : SourceLoc{};
+    }
+
+    [[nodiscard]] Token operator[](std::size_t i) const {
+      return {kinds_[i], repr(i), symbol(i), value(i), loc(i)};
+    }
+  };
+
+} // namespace claire::parser
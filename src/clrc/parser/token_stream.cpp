@@ -0,0 +1,77 @@
+#include "token_stream.hpp"
+
+#include <cassert>
+
+namespace claire::parser {
+
+  TokenStream::TokenStream(Lexer &lexer)
+    : lexer_{&lexer}
+    , ring_{}
+    , head_{0}
+    , size_{0}
+    , buffer_{nullptr}
+    , tokens_{}
+    , cursor_{0} {
+  }
+
+  TokenStream::TokenStream(TokenBuffer const &buffer)
+    : lexer_{nullptr}
+    , ring_{}
+    , head_{0}
+    , size_{0}
+    , buffer_{&buffer}
+    , tokens_{}
+    , cursor_{0} {
+  }
+
+  TokenStream::TokenStream(std::span<Token const> tokens)
+    : lexer_{nullptr}
+    , ring_{}
+    , head_{0}
+    , size_{0}
+    , buffer_{nullptr}
+    , tokens_{tokens}
+    , cursor_{0} {
+  }
+
+  Token TokenStream::token(std::size_t n) {
+    if (buffer_) {
+      auto i = cursor_ + n;
+      return i < buffer_->size() ? (*buffer_)[i] : Token{TokenKind::eEndOfInput, {}, {}};
+    }
+    if (not lexer_) {
+      auto i = cursor_ + n;
+      return i < tokens_.size() ? tokens_[i] : Token{TokenKind::eEndOfInput, {}, {}};
+    }
+    return fill(n) ? ring_[(head_ + n) % lookahead] : Token{TokenKind::eEndOfInput, {}, {}};
+  }
+
+  void TokenStream::advance() {
+    if (not lexer_) {
+      if (cursor_ < (buffer_ ? buffer_->size() : tokens_.size())) {
+        ++cursor_;
+      }
+      return;
+    }
+
+    // Make sure the front token has been pulled before it is dropped
+    if (fill(0)) {
+      head_ = (head_ + 1) % lookahead;
+      --size_;
+    }
+  }
+
+  bool TokenStream::fill(std::size_t n) {
+    assert(n < lookahead);
+
+    for (; size_ <= n; ++size_) {
+      auto tok = lexer_->next_token();
+      if (not tok) {
+        return false;
+      }
+      ring_[(head_ + size_) % lookahead] = *tok;
+    }
+    return true;
+  }
+
+} // namespace claire::parser
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <span>
+
+#include "lexer.hpp"
+#include "token.hpp"
+#include "token_buffer.hpp"
+
+namespace claire::parser {
+
+  /// Sequence of tokens consumed front to back by the parser
+  ///
+  /// A stream either walks tokens that were already lexed, in place, or pulls tokens on
+  /// demand from a `Lexer`. In the latter case at most `lookahead` tokens are buffered
+  /// in a ring, so token memory is bounded by lookahead depth rather than source size.
+  /// Sources are best lexed straight into a `TokenBuffer`, whose dense kinds are what
+  /// the parser mostly looks at.
+  class TokenStream {
+  public:
+    static constexpr std::size_t lookahead = 4;
+
+  private:
+    Lexer                       *lexer_;
+    std::array<Token, lookahead> ring_;
+    std::size_t                  head_;
+    std::size_t                  size_;
+
+    TokenBuffer const     *buffer_;
+    // Tokens materialized elsewhere, walked if there is neither a lexer nor a buffer
+    std::span<Token const> tokens_;
+    std::size_t            cursor_;
+
+  public:
+    explicit TokenStream(Lexer &lexer);
+
+    explicit TokenStream(TokenBuffer const &buffer);
+
+    /// \param tokens outlive the stream
+    explicit TokenStream(std::span<Token const> tokens);
+
+    TokenStream(TokenStream const &) = delete;
+    TokenStream &operator=(TokenStream const &) = delete;
+
+    /// \param n offset from the front of the stream, must be less than `lookahead`
+    /// \return kind of the n-th upcoming token, or TokenKind::eEndOfInput past the end
+    ///         of the stream
+    TokenKind kind(std::size_t n = 0) {
+      if (buffer_) {
+        auto i = cursor_ + n;
+        return i < buffer_->size() ? buffer_->kind(i) : TokenKind::eEndOfInput;
+      }
+      if (not lexer_) {
+        auto i = cursor_ + n;
+        return i < tokens_.size() ? tokens_[i].kind : TokenKind::eEndOfInput;
+      }
+      return fill(n) ? ring_[(head_ + n) % lookahead].kind : TokenKind::eEndOfInput;
+    }
+
+    /// \param n offset from the front of the stream, must be less than `lookahead`
+    /// \return the n-th upcoming token, with kind TokenKind::eEndOfInput past the end of
+    ///         the stream
+    Token token(std::size_t n = 0);
+
+    /// Drops the front of the stream
+    void advance();
+
+  private:
+    /// Pulls tokens from the lexer until the n-th one is buffered
+    ///
+    /// \return false if the source ran out before that
+    bool fill(std::size_t n);
+  };
+
+} // namespace claire::parser
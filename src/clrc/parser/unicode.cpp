@@ -0,0 +1,102 @@
+#include "unicode.hpp"
+
+#include <cstring>
+
+#include "xid_tables.hpp"
+
+namespace claire::parser {
+
+  namespace {
+
+    xid::Block const &block_of(char32_t cp) {
+      auto block = static_cast<std::size_t>(cp >> 8);
+      return xid::blocks[block < xid::index.size() ? xid::index[block] : xid::index.back()];
+    }
+
+    bool test(std::array<std::uint64_t, 4> const &bits, char32_t cp) {
+      return (bits[(cp >> 6) & 3] >> (cp & 63)) & 1;
+    }
+
+    // Range of the byte following a lead byte, as per table 3-7 of the Unicode standard.
+    // Any other following byte is in [0x80, 0xbf].
+    struct SecondByte {
+      unsigned char lo;
+      unsigned char hi;
+    };
+
+    constexpr SecondByte second_byte(unsigned char lead) {
+      switch (lead) {
+      case 0xe0:
+        return {0xa0, 0xbf};
+      case 0xed:
+        return {0x80, 0x9f};
+      case 0xf0:
+        return {0x90, 0xbf};
+      case 0xf4:
+        return {0x80, 0x8f};
+      default:
+        return {0x80, 0xbf};
+      }
+    }
+
+    // Length of the sequence started by `lead`, 0 if it cannot start one
+    constexpr std::size_t sequence_size(unsigned char lead) {
+      if (lead < 0x80) {
+        return 1;
+      }
+      if (lead < 0xc2) {
+        return 0;
+      }
+      if (lead < 0xe0) {
+        return 2;
+      }
+      if (lead < 0xf0) {
+        return 3;
+      }
+      return lead < 0xf5 ? 4 : 0;
+    }
+
+  } // namespace
+
+  bool is_xid_start(char32_t cp) {
+    return test(block_of(cp).start, cp);
+  }
+
+  bool is_xid_continue(char32_t cp) {
+    return test(block_of(cp).cont, cp);
+  }
+
+  std::size_t valid_utf8_prefix(char const *begin, std::size_t size) {
+    auto const *bytes = reinterpret_cast<unsigned char const *>(begin);
+
+    for (std::size_t i = 0; i < size;) {
+      if (std::uint64_t word; i + 8 <= size) {
+        std::memcpy(&word, bytes + i, sizeof(word));
+        if ((word & 0x8080808080808080u) == 0) {
+          i += 8;
+          continue;
+        }
+      }
+
+      auto lead = bytes[i];
+      auto len  = sequence_size(lead);
+      if (len == 0 or i + len > size) {
+        return i;
+      }
+      if (len > 1) {
+        auto [lo, hi] = second_byte(lead);
+        if (bytes[i + 1] < lo or bytes[i + 1] > hi) {
+          return i;
+        }
+        for (std::size_t j = 2; j < len; ++j) {
+          if ((bytes[i + j] & 0xc0) != 0x80) {
+            return i;
+          }
+        }
+      }
+      i += len;
+    }
+    return size;
+  }
+
+} // namespace claire::parser
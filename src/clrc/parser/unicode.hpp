@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace claire::parser {
+
+  struct CodePoint {
+    char32_t     value;
+    // Number of bytes of its UTF-8 encoding
+    std::uint8_t size;
+  };
+
+  /// Decodes the code point starting at `ptr`, which must be valid UTF-8
+  inline CodePoint decode_utf8(char const *ptr) {
+    auto const *bytes = reinterpret_cast<unsigned char const *>(ptr);
+    auto        lead  = bytes[0];
+    if (lead < 0x80) {
+      return {lead, 1};
+    }
+    if (lead < 0xe0) {
+      return {static_cast<char32_t>((lead & 0x1f) << 6 | (bytes[1] & 0x3f)), 2};
+    }
+    if (lead < 0xf0) {
+      return {static_cast<char32_t>(
+                (lead & 0x0f) << 12 | (bytes[1] & 0x3f) << 6 | (bytes[2] & 0x3f)),
+        3};
+    }
+    return {static_cast<char32_t>((lead & 0x07) << 18 | (bytes[1] & 0x3f) << 12 |
+                                  (bytes[2] & 0x3f) << 6 | (bytes[3] & 0x3f)),
+      4};
+  }
+
+  /// \return true if `cp` may start an identifier, as per Unicode's XID_Start
+  bool is_xid_start(char32_t cp);
+
+  /// \return true if `cp` may follow the start of an identifier, as per XID_Continue
+  bool is_xid_continue(char32_t cp);
+
+  /// Portable UTF-8 validation, skipping over ASCII a word at a time
+  ///
+  /// \return length of the longest prefix of `[begin, begin + size)` made of complete and
+  ///         well-formed UTF-8 sequences, i.e. `size` if it is all valid
+  std::size_t valid_utf8_prefix(char const *begin, std::size_t size);
+
+} // namespace claire::parser
@@ -0,0 +1,181 @@
+#include "source.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <limits>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "exception.hpp"
+#include "parser/scan.hpp"
+#include "source_manager.hpp"
+
+namespace claire {
+
+  namespace {
+
+    // Offsets into a source, its NUL sentinel included, are 32 bits wide everywhere
+    void check_size(std::string const &path, std::size_t size) {
+      if (size >= std::numeric_limits<std::uint32_t>::max()) {
+        throw source_error{path, EFBIG};
+      }
+    }
+
+  } // namespace
+
+  Source::Source(std::string path)
+    : path_{std::move(path)}
+    , data_{""}
+    , size_{0}
+    , mapping_{} {
+
+    if (path_ == "-") {
+      read(STDIN_FILENO);
+      check_size(path_, size_);
+      base_ = SourceManager::global().reserve(*this);
+      return;
+    }
+
+    auto fd = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      throw source_error{path_, errno};
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) < 0) {
+      auto err = errno;
+      ::close(fd);
+      throw source_error{path_, err};
+    }
+
+    try {
+      check_size(path_, static_cast<std::size_t>(st.st_size));
+      if (S_ISREG(st.st_mode) and st.st_size > 0) {
+        map(fd, static_cast<std::size_t>(st.st_size));
+      } else if (not S_ISREG(st.st_mode)) {
+        read(fd);
+        check_size(path_, size_);
+      }
+    } catch (...) {
+      ::close(fd);
+      throw;
+    }
+    ::close(fd);
+
+    base_ = SourceManager::global().reserve(*this);
+  }
+
+  Source::Source(std::string path, std::string text)
+    : Source{std::move(path), std::move(text), true} {
+  }
+
+  Source Source::detached(std::string path, std::string text) {
+    return Source{std::move(path), std::move(text), false};
+  }
+
+  Source::Source(std::string path, std::string text, bool laid_out)
+    : path_{std::move(path)}
+    , data_{nullptr}
+    , size_{0}
+    , mapping_{}
+    , buffer_{std::move(text)} {
+    // std::string keeps a NUL terminator past size(), which doubles as the sentinel
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    check_size(path_, size_);
+    if (laid_out) {
+      base_ = SourceManager::global().reserve(*this);
+    }
+  }
+
+  Source::~Source() {
+    if (base_.valid()) {
+      SourceManager::global().release(*this);
+    }
+  }
+
+  Source::Mapping::~Mapping() {
+    if (addr) {
+      ::munmap(addr, len);
+    }
+  }
+
+  SourcePosition Source::position(std::size_t offset) const {
+    std::call_once(line_starts_once_, [this]() {
+      line_starts_.push_back(0);
+
+      // Lines run like comments, up to the next line feed or NUL
+      for (auto const *ptr = data_, *end = data_ + size_; ptr < end; ++ptr) {
+        ptr += parser::scan.comment(ptr);
+        if (*ptr == '\n') {
+          line_starts_.push_back(static_cast<std::uint32_t>(ptr + 1 - data_));
+        }
+      }
+    });
+
+    auto line = std::upper_bound(line_starts_.begin(), line_starts_.end(), offset) - 1;
+    return {static_cast<std::uint32_t>(line - line_starts_.begin() + 1),
+      static_cast<std::uint32_t>(offset - *line + 1)};
+  }
+
+  void Source::map(int fd, std::size_t size) {
+    auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    auto len  = (size + 1 + page - 1) & ~(page - 1);
+
+    // Reserve one byte past the end of the file as zeroed anonymous memory, then map the
+    // file over the front of the reservation. The kernel zero-fills the remainder of the
+    // last file page, so the text is always followed by a NUL sentinel, even when the
+    // file size is an exact multiple of the page size.
+    auto reserved =
+      ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (reserved == MAP_FAILED) {
+      throw source_error{path_, errno};
+    }
+
+    auto mapped = ::mmap(reserved, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+    if (mapped == MAP_FAILED) {
+      auto err = errno;
+      ::munmap(reserved, len);
+      throw source_error{path_, err};
+    }
+    ::madvise(mapped, size, MADV_SEQUENTIAL);
+
+    mapping_.addr = mapped;
+    mapping_.len  = len;
+    data_         = static_cast<char const *>(mapped);
+    size_         = size;
+  }
+
+  void Source::read(int fd) {
+    constexpr std::size_t initial_capacity = 64 * 1024;
+
+    // std::string keeps a NUL terminator past size(), which doubles as the sentinel
+    buffer_.resize(initial_capacity);
+
+    std::size_t len = 0;
+    for (;;) {
+      if (len == buffer_.size()) {
+        buffer_.resize(buffer_.size() * 2);
+      }
+
+      auto n = ::read(fd, buffer_.data() + len, buffer_.size() - len);
+      if (n < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        throw source_error{path_, errno};
+      }
+      if (n == 0) {
+        break;
+      }
+      len += static_cast<std::size_t>(n);
+    }
+
+    buffer_.resize(len);
+    data_ = buffer_.data();
+    size_ = len;
+  }
+
+} // namespace claire
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "source_loc.hpp"
+
+namespace claire {
+
+  /// 1-based line and byte column within a source
+  struct SourcePosition {
+    std::uint32_t line;
+    std::uint32_t col;
+
+    friend bool operator==(SourcePosition const &lhs, SourcePosition const &rhs) = default;
+  };
+
+  /// Replacement of `removed` bytes starting at `offset` by the `inserted` text
+  struct TextEdit {
+    std::size_t      offset;
+    std::size_t      removed;
+    std::string_view inserted;
+  };
+
+  /// Owns the text of a single source file. Tokens and other lexical artifacts hold
+  /// views into this buffer, so a `Source` must outlive everything derived from it.
+  ///
+  /// Regular files are memory-mapped, anything else (pipes, stdin via "-") is read in
+  /// bulk. Either way the text is followed by a NUL sentinel, which the lexer relies
+  /// on as its end-of-file equivalence class.
+  class Source {
+    // Private mapping of a file, unmapped along with the source, or as soon as its
+    // construction throws
+    struct Mapping {
+      void       *addr{};
+      std::size_t len{};
+
+      Mapping() = default;
+
+      Mapping(Mapping const &) = delete;
+      Mapping &operator=(Mapping const &) = delete;
+
+      ~Mapping();
+    };
+
+    std::string path_;
+    char const *data_;
+    std::size_t size_;
+
+    // Backing storage, either a private mapping or an owned buffer
+    Mapping     mapping_;
+    std::string buffer_;
+
+    // Offsets of the first byte of every line, built on first use
+    mutable std::once_flag             line_starts_once_;
+    mutable std::vector<std::uint32_t> line_starts_;
+
+    // Location of the first byte, assigned by the `SourceManager` unless detached
+    SourceLoc base_;
+
+  public:
+    /// \throws source_error if the source cannot be read, or is 4 GiB or larger
+    explicit Source(std::string path);
+
+    /// Source backed by in-memory text, e.g. an editor buffer
+    ///
+    /// \throws source_error if the text is 4 GiB or larger
+    Source(std::string path, std::string text);
+
+    /// Source backed by in-memory text that is not laid out by the `SourceManager`, e.g.
+    /// part of an editor buffer lexed again, whose locations are all unknown
+    ///
+    /// \throws source_error if the text is 4 GiB or larger
+    static Source detached(std::string path, std::string text);
+
+    Source(Source const &) = delete;
+    Source &operator=(Source const &) = delete;
+
+    ~Source();
+
+    [[nodiscard]] std::string const &path() const {
+      return path_;
+    }
+
+    [[nodiscard]] std::string_view text() const {
+      return {data_, size_};
+    }
+
+    /// NUL-terminated view of the source text
+    [[nodiscard]] char const *data() const {
+      return data_;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+      return size_;
+    }
+
+    /// \return location of the byte at `offset`, the NUL sentinel included, unknown if
+    ///         the source is detached
+    [[nodiscard]] SourceLoc loc(std::size_t offset) const {
+      if (not base_.valid()) {
+        return SourceLoc{};
+      }
+      return SourceLoc{base_.offset() + static_cast<std::uint32_t>(offset)};
+    }
+
+    /// \param loc location within this source
+    /// \return byte offset of `loc`
+    [[nodiscard]] std::size_t offset(SourceLoc loc) const {
+      return loc.offset() - base_.offset();
+    }
+
+    /// Resolves the line and column of a byte offset
+    ///
+    /// Positions are not tracked while lexing. Instead, the first call indexes the start
+    /// of every line, and each lookup is a binary search over that index.
+    [[nodiscard]] SourcePosition position(std::size_t offset) const;
+
+  private:
+    Source(std::string path, std::string text, bool laid_out);
+
+    void map(int fd, std::size_t size);
+
+    void read(int fd);
+  };
+
+} // namespace claire
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+
+namespace claire {
+
+  /// Location of a byte in any of the loaded sources
+  ///
+  /// Sources are laid out one after another in a single location space by the
+  /// `SourceManager`, so a location is a plain 32-bit offset into that space rather than
+  /// a file, line and column. Resolving it back is left to the rare cases that need it,
+  /// such as printing a diagnostic.
+  class SourceLoc {
+    std::uint32_t offset_;
+
+  public:
+    /// Unknown location
+    constexpr SourceLoc()
+      : offset_{0} {
+    }
+
+    constexpr explicit SourceLoc(std::uint32_t offset)
+      : offset_{offset} {
+    }
+
+    [[nodiscard]] constexpr std::uint32_t offset() const {
+      return offset_;
+    }
+
+    [[nodiscard]] constexpr bool valid() const {
+      return offset_ != 0;
+    }
+
+    friend constexpr auto operator<=>(SourceLoc lhs, SourceLoc rhs) = default;
+  };
+
+} // namespace claire
@@ -0,0 +1,78 @@
+#include "source_manager.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+namespace claire {
+
+  SourceManager::SourceManager()
+    : next_{1} {
+  }
+
+  SourceManager::~SourceManager() {
+    // Owned sources release their range on destruction, while the ranges are still alive
+    sources_.clear();
+  }
+
+  SourceManager &SourceManager::global() {
+    static SourceManager manager{};
+    return manager;
+  }
+
+  Source const &SourceManager::load(std::string path) {
+    auto source = std::make_unique<Source>(std::move(path));
+
+    auto lock = std::unique_lock{mutex_};
+    return *sources_.emplace_back(std::move(source));
+  }
+
+  Source const &SourceManager::add(std::string path, std::string text) {
+    auto source = std::make_unique<Source>(std::move(path), std::move(text));
+
+    auto lock = std::unique_lock{mutex_};
+    return *sources_.emplace_back(std::move(source));
+  }
+
+  Source const *SourceManager::find(SourceLoc loc) const {
+    auto it = std::upper_bound(ranges_.begin(), ranges_.end(), loc.offset(),
+      [](std::uint32_t offset, Range const &range) { return offset < range.begin; });
+    if (it == ranges_.begin() or loc.offset() >= std::prev(it)->end) {
+      return nullptr;
+    }
+    return std::prev(it)->source;
+  }
+
+  std::size_t SourceManager::size() const {
+    auto lock = std::shared_lock{mutex_};
+    return ranges_.size();
+  }
+
+  SourceLoc SourceManager::reserve(Source const &source) {
+    auto lock = std::unique_lock{mutex_};
+
+    // One past the last byte is the NUL sentinel, where end-of-file errors are located
+    auto len = source.size() + 1;
+    if (len > std::numeric_limits<std::uint32_t>::max() - next_) {
+      throw std::length_error{"source locations exhausted by '" + source.path() + "'"};
+    }
+
+    auto begin = next_;
+    next_ += static_cast<std::uint32_t>(len);
+    ranges_.push_back({begin, next_, &source});
+    return SourceLoc{begin};
+  }
+
+  void SourceManager::release(Source const &source) {
+    auto lock = std::unique_lock{mutex_};
+
+    auto begin = source.loc(0).offset();
+    auto it    = std::lower_bound(ranges_.begin(), ranges_.end(), begin,
+      [](Range const &range, std::uint32_t offset) { return range.begin < offset; });
+    if (it != ranges_.end() and it->source == &source) {
+      ranges_.erase(it);
+    }
+  }
+
+} // namespace claire
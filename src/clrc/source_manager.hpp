@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "source.hpp"
+#include "source_loc.hpp"
+
+namespace claire {
+
+  /// Owns the sources loaded for a compilation and lays out every source, loaded here or
+  /// not, in a single location space
+  ///
+  /// Each `Source` is handed a range of `SourceLoc`s when it is constructed, one per byte
+  /// plus its NUL sentinel, and drops it when destroyed. Ranges are handed out in
+  /// increasing order and never reused, so the source containing a location is found by
+  /// binary search, a token only needs 32 bits to know where it came from, however many
+  /// files are involved, and a location outliving its source resolves to nothing rather
+  /// than to whichever source came next.
+  class SourceManager {
+    struct Range {
+      std::uint32_t begin;
+      std::uint32_t end;
+      Source const *source;
+    };
+
+    mutable std::shared_mutex mutex_;
+    // Sorted by `begin`, since ranges are handed out in increasing order
+    std::vector<Range>        ranges_;
+    std::uint32_t             next_;
+
+    std::vector<std::unique_ptr<Source>> sources_;
+
+    SourceManager();
+
+  public:
+    SourceManager(SourceManager const &) = delete;
+    SourceManager &operator=(SourceManager const &) = delete;
+
+    ~SourceManager();
+
+    static SourceManager &global();
+
+    /// Loads a source that lives as long as the manager
+    ///
+    /// \param path
+    /// \return the loaded source
+    /// \throws source_error if the source cannot be read
+    Source const &load(std::string path);
+
+    /// Adds in-memory text that lives as long as the manager
+    Source const &add(std::string path, std::string text);
+
+    /// Calls `fn` with the live source containing `loc`, or nullptr if there is none
+    ///
+    /// The source cannot be destroyed until `fn` returns, which must not construct nor
+    /// destroy sources itself.
+    ///
+    /// \return whatever `fn` returns
+    template <typename Fn>
+    auto resolve(SourceLoc loc, Fn &&fn) const {
+      auto lock = std::shared_lock{mutex_};
+      return std::forward<Fn>(fn)(find(loc));
+    }
+
+    /// \return the number of sources currently laid out
+    [[nodiscard]] std::size_t size() const;
+
+  private:
+    friend class Source;
+
+    /// \throws std::length_error if the 32-bit location space is exhausted
+    SourceLoc reserve(Source const &source);
+
+    void release(Source const &source);
+
+    /// \return the live source containing `loc`, or nullptr if there is none, with the
+    ///         lock held
+    [[nodiscard]] Source const *find(SourceLoc loc) const;
+  };
+
+} // namespace claire
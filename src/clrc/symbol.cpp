@@ -0,0 +1,76 @@
+#include "symbol.hpp"
+
+#include <array>
+#include <mutex>
+
+namespace claire {
+
+  std::string_view Symbol::str() const {
+    return Interner::global().spelling(*this);
+  }
+
+  std::ostream &operator<<(std::ostream &os, Symbol sym) {
+    return os << sym.str();
+  }
+
+  Interner::Interner() {
+    spellings_.emplace_back();
+    ids_.emplace(std::string_view{}, 0);
+  }
+
+  Symbol Interner::intern(std::string_view str) {
+    {
+      // Most lookups are for identifiers seen before
+      auto lock = std::shared_lock{mutex_};
+      if (auto it = ids_.find(str); it != ids_.end()) {
+        return Symbol{it->second};
+      }
+    }
+
+    auto lock = std::unique_lock{mutex_};
+    if (auto it = ids_.find(str); it != ids_.end()) {
+      return Symbol{it->second};
+    }
+
+    auto spelling = std::string_view{storage_.emplace_back(str)};
+    auto id       = static_cast<std::uint32_t>(spellings_.size());
+    spellings_.push_back(spelling);
+    ids_.emplace(spelling, id);
+    return Symbol{id};
+  }
+
+  std::string_view Interner::spelling(Symbol sym) const {
+    auto lock = std::shared_lock{mutex_};
+    return spellings_[sym.id()];
+  }
+
+  std::size_t Interner::size() const {
+    auto lock = std::shared_lock{mutex_};
+    return spellings_.size();
+  }
+
+  Interner &Interner::global() {
+    static Interner interner{};
+    return interner;
+  }
+
+  Symbol intern(std::string_view str) {
+    struct CacheEntry {
+      std::string_view spelling;
+      Symbol           symbol;
+    };
+
+    // Direct-mapped, so a hit costs one hash and one comparison and takes no lock. The
+    // spellings point into the global interner and never dangle.
+    constexpr std::size_t                           cache_size = 4096;
+    thread_local std::array<CacheEntry, cache_size> cache{};
+
+    auto &entry = cache[std::hash<std::string_view>{}(str) % cache_size];
+    if (entry.spelling != str) {
+      entry.symbol   = Interner::global().intern(str);
+      entry.spelling = Interner::global().spelling(entry.symbol);
+    }
+    return entry.symbol;
+  }
+
+} // namespace claire
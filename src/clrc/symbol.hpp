@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <robin_hood.h>
+
+namespace claire {
+
+  /// Interned string, compared and hashed by its 32-bit id
+  class Symbol {
+    std::uint32_t id_;
+
+  public:
+    /// The empty string
+    constexpr Symbol()
+      : id_{0} {
+    }
+
+    constexpr explicit Symbol(std::uint32_t id)
+      : id_{id} {
+    }
+
+    [[nodiscard]] constexpr std::uint32_t id() const {
+      return id_;
+    }
+
+    [[nodiscard]] constexpr bool empty() const {
+      return id_ == 0;
+    }
+
+    /// \return spelling of this symbol in the global interner
+    [[nodiscard]] std::string_view str() const;
+
+    friend constexpr bool operator==(Symbol lhs, Symbol rhs) = default;
+
+    friend std::ostream &operator<<(std::ostream &os, Symbol sym);
+  };
+
+  /// Thread-safe table of interned strings
+  ///
+  /// Ids are dense and handed out in order of first appearance, the empty string always
+  /// being 0. Spellings are owned by the interner and stay valid for its lifetime.
+  class Interner {
+    mutable std::shared_mutex                                        mutex_;
+    robin_hood::unordered_flat_map<std::string_view, std::uint32_t> ids_;
+    std::vector<std::string_view>                                    spellings_;
+
+    // Never moves its elements, so views into them stay valid
+    std::deque<std::string> storage_;
+
+  public:
+    Interner();
+
+    Interner(Interner const &) = delete;
+    Interner &operator=(Interner const &) = delete;
+
+    Symbol intern(std::string_view str);
+
+    [[nodiscard]] std::string_view spelling(Symbol sym) const;
+
+    [[nodiscard]] std::size_t size() const;
+
+    /// Interner shared by the lexer, parser and code generator
+    static Interner &global();
+  };
+
+  /// Interns into the global interner, through a cache local to the calling thread
+  Symbol intern(std::string_view str);
+
+} // namespace claire
+
+template <>
+struct std::hash<claire::Symbol> {
+  std::size_t operator()(claire::Symbol sym) const noexcept {
+    return sym.id();
+  }
+};
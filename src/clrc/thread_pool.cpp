@@ -0,0 +1,122 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+namespace claire {
+
+  namespace {
+
+    // Pool and queue of the worker running on this thread, if any
+    thread_local ThreadPool const *worker_pool  = nullptr;
+    thread_local std::size_t       worker_queue = 0;
+
+  } // namespace
+
+  ThreadPool::ThreadPool(std::size_t num_threads)
+    : queued_{0}
+    , pending_{0}
+    , stop_{false} {
+    num_threads = std::max<std::size_t>(num_threads, 1);
+    for (std::size_t i = 0; i <= num_threads; ++i) {
+      queues_.push_back(std::make_unique<Queue>());
+    }
+
+    workers_.reserve(num_threads);
+    for (std::size_t i = 0; i < num_threads; ++i) {
+      workers_.emplace_back([this, i]() { work(i); });
+    }
+  }
+
+  ThreadPool::~ThreadPool() {
+    {
+      auto lock = std::unique_lock{mutex_};
+      stop_     = true;
+    }
+    wake_.notify_all();
+  }
+
+  void ThreadPool::submit(Task task) {
+    pending_.fetch_add(1);
+    {
+      auto lock = std::unique_lock{mutex_};
+      queued_.fetch_add(1);
+    }
+    {
+      auto &queue = *queues_[current_queue()];
+      auto  lock  = std::unique_lock{queue.mutex};
+      queue.tasks.push_back(std::move(task));
+    }
+    wake_.notify_one();
+  }
+
+  void ThreadPool::wait() {
+    auto index = current_queue();
+    for (Task task{}; pending_ > 0;) {
+      if (take(index, task)) {
+        run(task);
+        continue;
+      }
+
+      auto lock = std::unique_lock{mutex_};
+      wake_.wait(lock, [&]() { return pending_ == 0 or queued_ > 0; });
+    }
+  }
+
+  void ThreadPool::work(std::size_t index) {
+    worker_pool  = this;
+    worker_queue = index;
+
+    for (Task task{};;) {
+      if (take(index, task)) {
+        run(task);
+        continue;
+      }
+
+      auto lock = std::unique_lock{mutex_};
+      if (stop_ and queued_ == 0) {
+        return;
+      }
+      wake_.wait(lock, [&]() { return stop_ or queued_ > 0; });
+    }
+  }
+
+  bool ThreadPool::take(std::size_t index, Task &task) {
+    {
+      auto &own  = *queues_[index];
+      auto  lock = std::unique_lock{own.mutex};
+      if (not own.tasks.empty()) {
+        task = std::move(own.tasks.back());
+        own.tasks.pop_back();
+        return true;
+      }
+    }
+
+    for (std::size_t i = 1; i < queues_.size(); ++i) {
+      auto &victim = *queues_[(index + i) % queues_.size()];
+      auto  lock   = std::unique_lock{victim.mutex};
+      if (not victim.tasks.empty()) {
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void ThreadPool::run(Task &task) {
+    queued_.fetch_sub(1);
+    task();
+    task = nullptr;
+
+    // Wakes up threads in `wait` once the last task is done
+    if (pending_.fetch_sub(1) == 1) {
+      auto lock = std::unique_lock{mutex_};
+      wake_.notify_all();
+    }
+  }
+
+  std::size_t ThreadPool::current_queue() const {
+    return worker_pool == this ? worker_queue : queues_.size() - 1;
+  }
+
+} // namespace claire
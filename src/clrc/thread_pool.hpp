@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace claire {
+
+  /// Fixed set of worker threads, each with its own queue of tasks
+  ///
+  /// Workers run the newest task of their own queue first, and once it is empty steal
+  /// the oldest task of another queue. Tasks submitted by a task go to the queue of the
+  /// worker running it, so work fanning out stays on one thread until others run dry,
+  /// and whoever steals it takes the oldest, and likely largest, part of it.
+  ///
+  /// Tasks must not throw.
+  class ThreadPool {
+  public:
+    using Task = std::function<void()>;
+
+  private:
+    struct Queue {
+      std::mutex       mutex;
+      std::deque<Task> tasks;
+    };
+
+    // One per worker, then one for the threads outside the pool
+    std::vector<std::unique_ptr<Queue>> queues_;
+
+    std::mutex              mutex_;
+    std::condition_variable wake_;
+    // Tasks in queues, counted before they are pushed so that no sleeper misses one
+    std::atomic<std::size_t> queued_;
+    // Tasks submitted and not finished yet
+    std::atomic<std::size_t> pending_;
+    bool                     stop_;
+
+    // Last, so that workers are joined before anything they use is destroyed
+    std::vector<std::jthread> workers_;
+
+  public:
+    /// \param num_threads number of workers, at least one
+    explicit ThreadPool(std::size_t num_threads = std::thread::hardware_concurrency());
+
+    ThreadPool(ThreadPool const &) = delete;
+    ThreadPool &operator=(ThreadPool const &) = delete;
+
+    /// Runs every task left, then joins the workers
+    ~ThreadPool();
+
+    void submit(Task task);
+
+    /// Runs tasks on the calling thread as well, until every task submitted so far and
+    /// every task they submit in turn has finished
+    ///
+    /// \pre not called from a task of this pool
+    void wait();
+
+    [[nodiscard]] std::size_t size() const {
+      return workers_.size();
+    }
+
+  private:
+    void work(std::size_t index);
+
+    /// Takes the newest task of queue `index`, or else the oldest task of another queue
+    bool take(std::size_t index, Task &task);
+
+    void run(Task &task);
+
+    /// \return queue of the calling thread
+    [[nodiscard]] std::size_t current_queue() const;
+  };
+
+} // namespace claire
@@ -1,16 +1,10 @@
 #pragma once
 
-#include <fstream>
 #include <sstream>
 #include <string>
 #include <type_traits>
 
 namespace claire {
-  inline auto loads(std::string const &fpath) {
-    return std::string{std::istreambuf_iterator<char>(std::ifstream{fpath}.rdbuf()),
-      std::istreambuf_iterator<char>()};
-  }
-
   template <typename InputIt>
   auto join(InputIt first, InputIt last, std::string const &separator = "") {
     std::ostringstream res{};
@@ -5,4 +5,4 @@ using namespace boost::ut;
 using namespace ApprovalTests;
 
 auto           directory   = Approvals::useApprovalsSubdirectory("golden_files");
-constexpr auto stdlib_path = "../../src/stdlib/";
+constexpr auto stdlib_path = "../../src/std/";
@@ -1,22 +1,97 @@
+#include <algorithm>
+
+#include <llvm/IR/Instructions.h>
+
 #include "codegen/ir_code_generator.hpp"
 #include "fixtures.hpp"
-#include "parser/lexer.hpp"
-#include "parser/parser.hpp"
+#include "parser/module_loader.hpp"
 
 int main() {
   "hello_world"_test = []() {
-    constexpr auto source_fname = "../../examples/hello_world.clr";
-    auto           lexemes      = claire::parser::Lexer{source_fname}.tokenize();
-    auto           ast          = claire::parser::Parser{stdlib_path}.parse(lexemes);
+    constexpr auto source_fname = "../../tests/data/modules/hello.clr";
+    auto           loader       = claire::parser::ModuleLoader{{stdlib_path}};
+    auto           ast          = loader.load(source_fname);
+    expect(ast.has_value());
+    if (not ast) {
+      return;
+    }
 
     std::unique_ptr<claire::codegen::IRCodeGenerator> code_generator =
-      std::make_unique<claire::codegen::IRCodeGenerator>(source_fname);
+      std::make_unique<claire::codegen::IRCodeGenerator>(
+        source_fname, &loader.registry());
 
-    std::visit(*code_generator, ast->as_variant());
+    code_generator->visit(ast.value().root());
 
     code_generator->emit_object_code();
 
-    Approvals::verify(
-      code_generator->dumps(), Options().fileOptions().withFileExtension(".ll"));
+    // The target is the host's, which differs between toolchains
+    auto ir     = code_generator->dumps();
+    auto triple = ir.find("target triple = ");
+    if (triple != std::string::npos) {
+      ir.erase(triple, ir.find('\n', triple) + 1 - triple);
+    }
+    Approvals::verify(ir, Options().fileOptions().withFileExtension(".ll"));
+  };
+
+  "opened_modules"_test = []() {
+    // Math and Strings open each other, and are each lowered once
+    auto loader = claire::parser::ModuleLoader{{"../../tests/data/modules"}};
+    auto ast    = loader.load("../../tests/data/modules/lowering.clr");
+    expect(ast.has_value());
+    if (not ast) {
+      return;
+    }
+
+    auto code_generator =
+      claire::codegen::IRCodeGenerator{"lowering.clr", &loader.registry()};
+    code_generator.visit(ast.value().root());
+
+    auto ir = code_generator.dumps();
+    expect(ir.find("declare i32 @strlen(i8*)") != std::string::npos);
+    expect(ir.find("declare i32 @abs(i32)") != std::string::npos);
+    expect(ir.find("call i32 @strlen(") != std::string::npos);
+  };
+
+  "redeclared_callee"_test = []() {
+    // Bytes binds `strlen` with another signature than Strings, which LLVM declares once
+    // and casts for the other
+    auto loader = claire::parser::ModuleLoader{{"../../tests/data/modules"}};
+    auto ast    = loader.load("../../tests/data/modules/redeclared.clr");
+    expect(ast.has_value());
+    if (not ast) {
+      return;
+    }
+
+    auto code_generator =
+      claire::codegen::IRCodeGenerator{"redeclared.clr", &loader.registry()};
+    code_generator.visit(ast.value().root());
+
+    // Declared once, with the signature of Strings
+    auto const &mod    = code_generator.module();
+    auto const *strlen = mod.getFunction("strlen");
+    expect(strlen != nullptr);
+    expect(std::count_if(mod.begin(), mod.end(), [](llvm::Function const &fn) {
+      return fn.getName().startswith("strlen");
+    }) == 1);
+
+    // Called with the signature of Bytes
+    llvm::CallInst const *call{};
+    for (auto const &block : *mod.getFunction("main")) {
+      for (auto const &inst : block) {
+        if (auto const *found = llvm::dyn_cast<llvm::CallInst>(&inst)) {
+          call = found;
+        }
+      }
+    }
+
+    auto &ctx  = mod.getContext();
+    auto *type = llvm::FunctionType::get(
+      llvm::Type::getVoidTy(ctx), {llvm::Type::getInt8PtrTy(ctx)}, false);
+    expect(call != nullptr);
+    if (not call) {
+      return;
+    }
+    expect(call->getFunctionType() == type);
+    expect(call->getCalledOperand()->stripPointerCasts() == strlen);
   };
 }
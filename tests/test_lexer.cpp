@@ -1,12 +1,244 @@
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <unistd.h>
+
+#include "exception.hpp"
 #include "fixtures.hpp"
+#include "parser/edit_buffer.hpp"
 #include "parser/lexer.hpp"
+#include "source_manager.hpp"
 
 int main() {
   "hello_world"_test = []() {
-    auto lexemes = claire::parser::Lexer{"../../examples/hello_world.clr"}.tokenize();
+    auto source  = claire::Source{"../../examples/hello_world.clr"};
+    auto lexemes = claire::parser::Lexer{source}.tokenize();
     Approvals::verifyAll("hello_world.clr", lexemes);
   };
 
+  "hello_world.streaming"_test = []() {
+    auto source = claire::Source{"../../examples/hello_world.clr"};
+    auto lexer  = claire::parser::Lexer{source};
+
+    std::vector<claire::parser::Token> streamed{};
+    while (auto tok = lexer.next_token()) {
+      streamed.push_back(*tok);
+    }
+
+    expect(streamed == claire::parser::Lexer{source}.tokenize());
+  };
+
+  "hello_world.buffer"_test = []() {
+    auto source = claire::Source{"../../examples/hello_world.clr"};
+    auto buffer = claire::parser::Lexer{source}.tokenize_buffer();
+    auto tokens = claire::parser::Lexer{source}.tokenize();
+
+    expect(buffer.size() == tokens.size());
+    for (std::size_t i = 0; i < std::min(buffer.size(), tokens.size()); ++i) {
+      expect(buffer[i] == tokens[i]);
+    }
+  };
+
+  "symbols"_test = []() {
+    auto source = claire::Source{"../../examples/fib.clr"};
+    auto tokens = claire::parser::Lexer{source}.tokenize();
+
+    for (auto const &tok : tokens) {
+      if (tok.kind == claire::parser::TokenKind::eIdentifier) {
+        expect(tok.symbol == claire::intern(tok.repr));
+        expect(tok.symbol.str() == tok.repr);
+      } else {
+        expect(tok.symbol.empty());
+      }
+    }
+    expect(claire::intern("fib") != claire::intern("x"));
+  };
+
+  "spellings"_test = []() {
+    using namespace claire::parser;
+
+    // Every kind with a spelling is found back from it, and lexed back into it
+    std::size_t spelled = 0;
+    for (std::size_t i = 0; i < static_cast<std::size_t>(TokenKind::eCount); ++i) {
+      auto kind     = static_cast<TokenKind>(i);
+      auto spelling = spelling_of(kind);
+      if (spelling.empty()) {
+        continue;
+      }
+      ++spelled;
+      expect(spelling_table.find(spelling.data(), spelling.size()) == kind);
+
+      auto text   = std::string{spelling} + "\n";
+      auto source = claire::Source{"spelling.clr", text};
+      auto tokens = Lexer{source}.tokenize();
+      expect(tokens.size() == 1u and tokens[0].kind == kind and tokens[0].repr == spelling);
+    }
+    expect(spelled == std::size(token_spellings));
+
+    for (std::string_view miss : {"fun", "funcs", "u3", "::>", "lets"}) {
+      expect(not spelling_table.find(miss.data(), miss.size()));
+    }
+  };
+
+  "numerals"_test = []() {
+    using claire::parser::NumeralValue;
+
+    auto source = claire::Source{"numerals.clr",
+      "42 1_000_000 0xFF 0b1010 3.14 1e10 2.5e-3 18446744073709551616\n"};
+    auto tokens = claire::parser::Lexer{source}.tokenize();
+
+    expect(tokens.size() == 8u);
+    expect(tokens[0].value == NumeralValue::integer(42));
+    expect(tokens[1].value == NumeralValue::integer(1000000));
+    expect(tokens[2].value == NumeralValue::integer(0xff));
+    expect(tokens[3].value == NumeralValue::integer(0b1010));
+    expect(tokens[4].value == NumeralValue::floating(3.14));
+    expect(tokens[5].value == NumeralValue::floating(1e10));
+    expect(tokens[6].value == NumeralValue::floating(2.5e-3));
+    expect(tokens[7].value.big_integer().str() == "18446744073709551616");
+
+    auto buffer = claire::parser::Lexer{source}.tokenize_buffer();
+    for (std::size_t i = 0; i < buffer.size(); ++i) {
+      expect(buffer[i] == tokens[i]);
+    }
+
+    // Digit separators sit in between two digits of the numeral's radix
+    auto separated = claire::Source{"separated.clr", "1_0_0 0xF_F 0b1_0 1_0.2_5\n"};
+    tokens         = claire::parser::Lexer{separated}.tokenize();
+    expect(tokens.size() == 4u);
+    expect(tokens[0].value == NumeralValue::integer(100));
+    expect(tokens[1].value == NumeralValue::integer(0xff));
+    expect(tokens[2].value == NumeralValue::integer(0b10));
+    expect(tokens[3].value == NumeralValue::floating(10.25));
+
+    for (auto text : {"12abc\n", "1.foo\n", "0x\n", "0b\n", "0X\n", "0b12\n", "1e+\n",
+           "1__0\n", "1_\n", "0x_1\n", "0xF_\n", "0b1__0\n", "1_.5\n", "1e_5\n",
+           "1.5_\n"}) {
+      auto invalid = claire::Source{"invalid.clr", text};
+      expect(throws([&]() { claire::parser::Lexer{invalid}.tokenize(); }));
+
+      auto diagnostics = claire::Diagnostics{};
+      auto errors      = claire::parser::Lexer{invalid}.tokenize(diagnostics);
+      expect(diagnostics.size() == 1u);
+      expect(errors.size() == 1u and errors[0].kind == claire::parser::TokenKind::eError);
+    }
+  };
+
+  "eof"_test = []() {
+    using claire::parser::TokenKind;
+
+    // Tokens still pending at the end of a source without a final line feed are emitted
+    auto source = claire::Source{"eof.clr", "let x = 42 |> f |>"};
+    auto tokens = claire::parser::Lexer{source}.tokenize();
+
+    expect(tokens.size() == 7u);
+    expect(tokens[3].kind == TokenKind::eNumeral and tokens[3].repr == "42");
+    expect(tokens[5].kind == TokenKind::eIdentifier and tokens[5].repr == "f");
+    expect(tokens.back().repr == "|>");
+
+    for (auto text : {"x", "42", "größe"}) {
+      auto last = claire::Source{"eof.clr", text};
+      tokens    = claire::parser::Lexer{last}.tokenize();
+      expect(tokens.size() == 1u and tokens[0].repr == text);
+    }
+  };
+
+  "parallel"_test = []() {
+    std::string sources[]{
+      "../../examples/hello_world.clr",
+      "../../examples/fib.clr",
+      "../../tests/data/long_runs.clr",
+    };
+
+    for (auto const &src : sources) {
+      auto source = claire::Source{src};
+      // Tiny chunks to force a split at every line
+      auto parallel = claire::parser::Lexer{source}.tokenize_parallel(4, 1);
+      expect(parallel == claire::parser::Lexer{source}.tokenize());
+    }
+
+    auto source = claire::Source{"../../tests/data/unsupported_multi_operator.clr"};
+    auto lexer  = claire::parser::Lexer{source};
+    expect(throws([&]() { lexer.tokenize_parallel(4, 1); }));
+  };
+
+  "positions"_test = []() {
+    auto source = claire::Source{"../../examples/hello_world.clr"};
+
+    expect(source.position(0) == claire::SourcePosition{1, 1});
+    // std::puts
+    expect(source.position(source.text().find("std")) == claire::SourcePosition{2, 3});
+    // Closing brace on the last line
+    expect(source.position(source.text().rfind('}')) == claire::SourcePosition{3, 1});
+  };
+
+  "relex"_test = []() {
+    using claire::parser::EditBuffer;
+    using claire::parser::Lexer;
+
+    auto same_tokens = [](EditBuffer const &buffer, std::string const &path) {
+      auto text   = buffer.text();
+      auto source = claire::Source{path, text};
+      auto edited = buffer.tokens(source);
+      auto errors = claire::Diagnostics{};
+      auto lexed  = Lexer{source}.tokenize_buffer(errors);
+
+      expect(edited.size() == lexed.size());
+      for (std::size_t i = 0; i < std::min(edited.size(), lexed.size()); ++i) {
+        expect(edited[i] == lexed[i]);
+      }
+    };
+
+    auto source = claire::Source{"../../examples/fib.clr"};
+    auto buffer = EditBuffer{source};
+
+    auto fib = source.text().find("fib");
+    claire::TextEdit edits[]{
+      // Rename within an identifier
+      {fib + 1, 2, "ibonacci"},
+      // Split an identifier in two
+      {fib + 1, 0, " "},
+      // Join a token with its neighbour
+      {source.text().find(' '), 1, ""},
+      // Prepend a line
+      {0, 0, "let one = 1\n"},
+      // Open a string literal, then close it
+      {0, 0, "\""},
+      {1, 0, "\""},
+    };
+
+    for (auto const &edit : edits) {
+      buffer.edit(edit);
+      same_tokens(buffer, source.path());
+    }
+
+    // Edits far apart in a large source only relex the lines they touch
+    auto text = std::string{};
+    for (int i = 0; i < 10000; ++i) {
+      text += "let x" + std::to_string(i) + " = " + std::to_string(i) + " + y\n";
+    }
+    auto large      = claire::Source{"large.clr", text};
+    auto large_edit = EditBuffer{large};
+
+    claire::TextEdit large_edits[]{
+      {text.size() / 2, 0, "z"},
+      {10, 3, ""},
+      {text.size() - 4, 1, "\"w\""},
+      {text.size() / 3, 0, "let w = 2\nlet v = 3\n"},
+      {text.size() / 4, 1, "+"},
+    };
+    for (auto const &edit : large_edits) {
+      expect(large_edit.edit(edit) < 16u);
+    }
+    same_tokens(large_edit, large.path());
+  };
+
+  "long_runs"_test = []() {
+    auto source  = claire::Source{"../../tests/data/long_runs.clr"};
+    auto lexemes = claire::parser::Lexer{source}.tokenize();
+    Approvals::verifyAll("long_runs.clr", lexemes);
+  };
+
   //  "fib"_test = []() {
   //    auto lexemes = claire::parser::Lexer{"../../examples/fib.clr"}.lex();
   //    Approvals::verifyAll("fib.clr", lexemes);
@@ -17,14 +249,137 @@ int main() {
   //    Approvals::verifyAll("io.clr", lexemes);
   //  };
   //
+  "diagnostics"_test = []() {
+    using claire::parser::TokenKind;
+
+    auto source =
+      claire::Source{"errors.clr", "let a = \"open\nlet b = 12abc ->| c\nlet d = 1\n"};
+
+    auto diagnostics = claire::Diagnostics{};
+    auto tokens      = claire::parser::Lexer{source}.tokenize(diagnostics);
+
+    // Every error is reported, and lexing goes on after each of them
+    expect(diagnostics.size() == 3u);
+    expect(std::count_if(tokens.begin(), tokens.end(), [](auto const &tok) {
+      return tok.kind == TokenKind::eError;
+    }) == 3);
+    expect(tokens.back().kind == TokenKind::eNumeral);
+
+    auto parallel = claire::Diagnostics{};
+    expect(claire::parser::Lexer{source}.tokenize_parallel(parallel, 4, 1) == tokens);
+    expect(parallel.size() == diagnostics.size());
+
+    std::ostringstream os{};
+    os << diagnostics[1];
+    expect(os.str() == "errors.clr:2:9: Invalid lexeme");
+  };
+
+  "unicode"_test = []() {
+    using claire::parser::TokenKind;
+
+    auto source = claire::Source{"unicode.clr", "let größe = \"→ naïve\" |> 名前 €\n"};
+
+    auto diagnostics = claire::Diagnostics{};
+    auto tokens      = claire::parser::Lexer{source}.tokenize(diagnostics);
+
+    expect(tokens.size() == 7u);
+    expect(tokens[1].kind == TokenKind::eIdentifier and tokens[1].repr == "größe");
+    expect(tokens[3].kind == TokenKind::eStringLiteral and tokens[3].repr == "\"→ naïve\"");
+    expect(tokens[5].kind == TokenKind::eIdentifier and tokens[5].repr == "名前");
+    // Code points outside of XID_Start cannot start an identifier
+    expect(tokens[6].kind == TokenKind::eError and tokens[6].repr == "€");
+    expect(diagnostics.size() == 1u);
+
+    // Malformed UTF-8 is reported once, and nothing is lexed
+    auto invalid = claire::Source{"invalid.clr", "let a = 1\nlet b\xc3 = \"\xed\xa0\x80\"\n"};
+    diagnostics  = claire::Diagnostics{};
+    expect(claire::parser::Lexer{invalid}.tokenize(diagnostics).empty());
+    expect(diagnostics.size() == 1u);
+    expect(claire::parser::Lexer{invalid}.tokenize_parallel(diagnostics, 4, 1).empty());
+
+    std::ostringstream os{};
+    os << diagnostics[0];
+    expect(os.str() == "invalid.clr:2:6: Invalid UTF-8");
+  };
+
+  "source_locations"_test = []() {
+    auto &manager = claire::SourceManager::global();
+    auto const &main   = manager.add("main.clr", "open IO\n");
+    auto const &module = manager.add("io.clr", "let puts = 1\n");
+
+    auto find = [&](claire::SourceLoc loc) {
+      return manager.resolve(loc, std::identity{});
+    };
+
+    // Both sources share one location space, without overlapping
+    auto tokens = claire::parser::Lexer{module}.tokenize();
+    expect(main.loc(main.size()) < module.loc(0));
+    expect(tokens[1].loc == module.loc(4));
+    expect(find(tokens[1].loc) == &module);
+    expect(find(main.loc(5)) == &main);
+    expect(find(claire::SourceLoc{}) == nullptr);
+
+    auto buffer = claire::parser::Lexer{module}.tokenize_buffer();
+    expect(buffer.loc(1) == tokens[1].loc);
+
+    // Sources outside of the manager are laid out all the same, until destroyed
+    auto loc = claire::SourceLoc{};
+    {
+      auto scratch = claire::Source{"scratch.clr", "x\n"};
+      loc          = scratch.loc(0);
+      expect(find(loc) == &scratch);
+    }
+    expect(find(loc) == nullptr);
+
+    // Their ranges are never reused, so that stale locations do not point elsewhere
+    {
+      auto again = claire::Source{"scratch.clr", "y\n"};
+      expect(again.loc(0) != loc and find(loc) == nullptr);
+
+      std::ostringstream os{};
+      os << claire::Diagnostic{claire::DiagnosticKind::eInvalidLexeme, loc, {}};
+      expect(os.str() == "Invalid lexeme");
+    }
+
+    // Detached sources are not laid out at all, like the text an edit relexes
+    auto laid_out = manager.size();
+    expect(claire::Source::detached("window.clr", "x\n").loc(0) == claire::SourceLoc{});
+
+    auto edited = claire::Source{"edited.clr", "let x = 1\n"};
+    auto editor = claire::parser::EditBuffer{edited};
+    for (int i = 0; i < 100; ++i) {
+      editor.edit({8, 1, "2"});
+    }
+    expect(manager.size() == laid_out + 1);
+  };
+
   "exception"_test = []() {
     std::string sources[]{
       "unsupported_multi_operator.clr",
     };
 
     for (auto const &src : sources) {
-      auto lexer = claire::parser::Lexer{"../../tests/data/" + src};
+      auto source = claire::Source{"../../tests/data/" + src};
+      auto lexer  = claire::parser::Lexer{source};
       expect(throws([&]() { lexer.tokenize(); }));
     }
   };
+
+  "source_too_large"_test = []() {
+    // Sparse, so that nothing is written nor mapped
+    auto path = std::filesystem::temp_directory_path() /
+                ("claire-test-large-" + std::to_string(::getpid()) + ".clr");
+    std::ofstream{path}.close();
+    std::filesystem::resize_file(path, std::uintmax_t{1} << 32);
+
+    auto too_large = false;
+    try {
+      auto source = claire::Source{path.string()};
+    } catch (claire::source_error const &) {
+      too_large = true;
+    }
+    expect(too_large);
+
+    std::filesystem::remove(path);
+  };
 }
@@ -1,7 +1,15 @@
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
 #include "fixtures.hpp"
 #include "parser/ast_pretty_printer.hpp"
+#include "parser/module_interface.hpp"
+#include "parser/module_loader.hpp"
 #include "parser/parser.hpp"
-#include "parser/token.h"
+#include "parser/token.hpp"
 
 int main() {
   using namespace claire::parser;
@@ -14,9 +22,9 @@ int main() {
       {TokenKind::eIdentifier, "my_variable"},
     };
 
-    auto it   = tokens.begin();
-    auto node = parse_simple_identifier_expression(it);
-    Approvals::verify(pp.pretty_print(node.get()));
+    auto ctx  = parse_context{tokens};
+    auto node = parse_simple_identifier_expression(ctx);
+    Approvals::verify(pp.pretty_print(node.value()));
   };
 
   "identifier_sequence.access_namespace"_test = []() {
@@ -29,9 +37,23 @@ int main() {
       {TokenKind::eIdentifier, "my_func"},
     };
 
-    auto it   = tokens.begin();
-    auto node = parse_identifier_sequence(it);
-    Approvals::verify(pp.pretty_print(node.get()));
+    auto ctx  = parse_context{tokens};
+    auto node = parse_identifier_sequence(ctx);
+    Approvals::verify(pp.pretty_print(node.value()));
+  };
+
+  "identifier_sequence.streaming"_test = []() {
+    auto pp = ASTPrettyPrinter{};
+
+    // std::puts
+    auto source = claire::Source{"../../tests/data/namespace_access.clr"};
+    auto lexer  = Lexer{source};
+    auto tokens = Lexer{source}.tokenize();
+
+    auto streamed     = parse_context{lexer};
+    auto materialized = parse_context{tokens};
+    expect(pp.pretty_print(parse_identifier_sequence(streamed).value()) ==
+           pp.pretty_print(parse_identifier_sequence(materialized).value()));
   };
 
   "expression_sequence.empty"_test = []() {
@@ -45,7 +67,7 @@ int main() {
 
     auto ctx  = parse_context{tokens};
     auto node = parse_expression_sequence(ctx);
-    Approvals::verify(pp.pretty_print(node.get()));
+    Approvals::verify(pp.pretty_print(node));
   };
 
   "expression_sequence.all_identifiers"_test = []() {
@@ -62,7 +84,7 @@ int main() {
 
     auto ctx  = parse_context{tokens};
     auto node = parse_expression_sequence(ctx);
-    Approvals::verify(pp.pretty_print(node.get()));
+    Approvals::verify(pp.pretty_print(node));
   };
 
   "function_call_expression.no_args"_test = []() {
@@ -75,9 +97,9 @@ int main() {
     };
 
     auto ctx    = parse_context{tokens};
-    auto callee = std::make_unique<IdentifierExpr>("my_func");
-    auto node   = parse_function_call_expression(ctx, std::move(callee));
-    Approvals::verify(pp.pretty_print(node.get()));
+    auto callee = ctx.make<IdentifierExpr>(claire::intern("my_func"));
+    auto node   = parse_function_call_expression(ctx, callee);
+    Approvals::verify(pp.pretty_print(node.value()));
   };
 
   "function_call_expression.one_arg"_test = []() {
@@ -91,9 +113,9 @@ int main() {
     };
 
     auto ctx    = parse_context{tokens};
-    auto callee = std::make_unique<IdentifierExpr>("my_func");
-    auto node   = parse_function_call_expression(ctx, std::move(callee));
-    Approvals::verify(pp.pretty_print(node.get()));
+    auto callee = ctx.make<IdentifierExpr>(claire::intern("my_func"));
+    auto node   = parse_function_call_expression(ctx, callee);
+    Approvals::verify(pp.pretty_print(node.value()));
   };
 
   "function_call_expression.two_or_more_args"_test = []() {
@@ -109,8 +131,332 @@ int main() {
     };
 
     auto ctx    = parse_context{tokens};
-    auto callee = std::make_unique<IdentifierExpr>("my_product");
-    auto node   = parse_function_call_expression(ctx, std::move(callee));
-    Approvals::verify(pp.pretty_print(node.get()));
+    auto callee = ctx.make<IdentifierExpr>(claire::intern("my_product"));
+    auto node   = parse_function_call_expression(ctx, callee);
+    Approvals::verify(pp.pretty_print(node.value()));
+  };
+
+  "recovery"_test = []() {
+    // my_func(a b, std::)
+    std::vector<Token> const tokens{
+      {TokenKind::eLParens, "("},
+      {TokenKind::eIdentifier, "a"},
+      {TokenKind::eIdentifier, "b"},
+      {TokenKind::eSeparator, ","},
+      {TokenKind::eRParens, ")"},
+      {TokenKind::eIdentifier, "std"},
+      {TokenKind::eAccessNamespace, "::"},
+    };
+
+    auto ctx    = parse_context{tokens};
+    auto callee = ctx.make<IdentifierExpr>(claire::intern("my_func"));
+    expect(parse_function_call_expression(ctx, callee).has_value());
+    expect(parse_identifier_sequence(ctx).has_value());
+
+    // Both errors are found in a single pass
+    expect(ctx.diagnostics.size() == 2u);
+    expect(ctx.kind() == TokenKind::eEndOfInput);
+
+    auto missing = parse_context{std::vector<Token>{}};
+    expect(not parse_simple_identifier_expression(missing).has_value());
+  };
+
+  "expression.precedence"_test = []() {
+    auto pp = ASTPrettyPrinter{};
+
+    auto source = claire::Source{"precedence.clr", "fib(x - 1) + fib(x - 2) < -x + 1\n"};
+    auto tokens = Lexer{source}.tokenize();
+    auto ctx    = parse_context{tokens};
+    auto expr   = parse_expression(ctx);
+    expect(ctx.kind() == TokenKind::eEndOfInput);
+    Approvals::verify(pp.pretty_print(expr.value()));
+  };
+
+  "expression.pipe"_test = []() {
+    auto pp = ASTPrettyPrinter{};
+
+    auto source = claire::Source{"pipe.clr", "40 |> fib() |> IO.puts()\n"};
+    auto tokens = Lexer{source}.tokenize();
+    auto ctx    = parse_context{tokens};
+    auto expr   = parse_expression(ctx);
+    expect(ctx.kind() == TokenKind::eEndOfInput);
+    Approvals::verify(pp.pretty_print(expr.value()));
+  };
+
+  "expression.long_chains"_test = []() {
+    constexpr std::size_t terms = 5000;
+
+    std::vector<Token> chain{{TokenKind::eIdentifier, "a"}};
+    std::vector<Token> pipes{{TokenKind::eNumeral, "1"}};
+    std::vector<Token> nested{};
+    for (std::size_t i = 0; i < terms; ++i) {
+      chain.emplace_back(i % 2 ? TokenKind::ePlus : TokenKind::eMinus, i % 2 ? "+" : "-");
+      chain.emplace_back(TokenKind::eIdentifier, "a");
+      pipes.emplace_back(TokenKind::ePipe, "|>");
+      pipes.emplace_back(TokenKind::eIdentifier, "f");
+      pipes.emplace_back(TokenKind::eLParens, "(");
+      pipes.emplace_back(TokenKind::eRParens, ")");
+      nested.emplace_back(TokenKind::eIdentifier, "f");
+      nested.emplace_back(TokenKind::eLParens, "(");
+      nested.emplace_back(TokenKind::eLParens, "(");
+    }
+    nested.emplace_back(TokenKind::eIdentifier, "a");
+    for (std::size_t i = 0; i < 2 * terms; ++i) {
+      nested.emplace_back(TokenKind::eRParens, ")");
+    }
+
+    // Operators, calls and parentheses are nodes, arguments are one sequence per call
+    std::pair<std::vector<Token> const &, std::size_t> cases[]{
+      {chain, 2 * terms + 1},
+      {pipes, 3 * terms + 1},
+      {nested, 3 * terms + 1},
+    };
+    for (auto const &[tokens, nodes] : cases) {
+      auto ctx  = parse_context{tokens};
+      auto expr = parse_expression(ctx);
+      expect(ctx.diagnostics.empty() and ctx.kind() == TokenKind::eEndOfInput);
+      // Callees are flattened past the tree
+      auto flat = FlatAST{expr.value()};
+      expect(flat.nodes().size() == nodes);
+    }
+
+    // Flat nodes only have 16 bits for their depth, which deeper trees do not fit in
+    std::vector<ASTNode> deep(std::size_t{std::numeric_limits<std::uint16_t>::max()} + 2);
+    for (std::size_t i = 0; i + 2 < deep.size(); ++i) {
+      deep[i].add(&deep[i + 1]);
+    }
+    expect(FlatAST{&deep.front()}.nodes().size() == deep.size() - 1);
+    deep[deep.size() - 2].add(&deep.back());
+    expect(throws([&]() { FlatAST{&deep.front()}; }));
+
+    // Unbalanced parentheses are skipped along with the error
+    std::vector<Token> const unbalanced{
+      {TokenKind::eIdentifier, "f"},
+      {TokenKind::eLParens, "("},
+      {TokenKind::eLParens, "("},
+      {TokenKind::eIdentifier, "a"},
+      {TokenKind::ePlus, "+"},
+      {TokenKind::eRParens, ")"},
+      {TokenKind::eRParens, ")"},
+      {TokenKind::eIdentifier, "b"},
+    };
+    auto ctx = parse_context{unbalanced};
+    expect(not parse_expression(ctx).has_value());
+    expect(ctx.token().repr == "b");
+  };
+
+  "declarations"_test = []() {
+    auto pp = ASTPrettyPrinter{};
+
+    auto source = claire::Source{"declarations.clr", R"(open IO
+module Math {
+  extern abs(x: u32) -> u32 "abs"
+}
+func main() -> u32 {
+  let fib \x: u32 when x < 3 = 1
+  40 |> fib() |> IO.puts()
+}
+)"};
+    auto tokens = Lexer{source}.tokenize();
+    auto ast    = Parser{}.parse(tokens);
+    expect(pp.pretty_print(FlatAST{ast.value().root()}) ==
+           pp.pretty_print(ast.value().root()));
+    Approvals::verify(pp.pretty_print(ast.value().root()));
+  };
+
+  "declarations.stdlib"_test = []() {
+    // Every module of the standard library parses without errors
+    std::size_t modules = 0;
+    for (auto const &entry : std::filesystem::directory_iterator{"../../src/std"}) {
+      if (entry.path().extension() != ".clr") {
+        continue;
+      }
+      ++modules;
+
+      auto source = claire::Source{entry.path().string()};
+      auto ast    = Parser{}.parse(Lexer{source}.tokenize());
+      expect(ast.has_value());
+    }
+    expect(modules > 0u);
+  };
+
+  "declarations.recovery"_test = []() {
+    auto source = claire::Source{"recovery.clr", R"(func main() {
+  let y = )
+  puts("ok")
+}
+open
+module M {
+)"};
+    auto tokens = Lexer{source}.tokenize();
+    auto ctx    = parse_context{tokens};
+    auto root   = Parser{}.parse(ctx);
+
+    // Every error is reported, and declarations past them are still parsed
+    expect(ctx.diagnostics.size() == 3u);
+    expect(std::ranges::distance(root->children()) == 2);
+    auto const *def = node_cast<FunctionDef>(*root->children().begin());
+    expect(def != nullptr and std::ranges::distance(def->body()->children()) == 1);
+  };
+
+  "declarations.expected"_test = []() {
+    // The type of a let argument is optional, so the error lists whatever may follow it
+    auto source = claire::Source{"expected.clr", "let f \\x )\n"};
+    auto tokens = Lexer{source}.tokenize();
+    auto ctx    = parse_context{tokens};
+    Parser{}.parse(ctx);
+
+    expect(ctx.diagnostics.size() == 1u and
+           ctx.diagnostics[0].detail == "expected ':', '\\', 'when' or '='");
+  };
+
+  "modules"_test = []() {
+    auto loader  = ModuleLoader{{"../../tests/data/modules"}, 4};
+    auto program = loader.load("../../tests/data/modules/main.clr");
+    expect(program.has_value());
+
+    // Math and Strings open each other, and each is loaded once
+    expect(loader.registry().size() == 2u);
+    auto const *math = loader.registry().find(claire::intern("Math"));
+    expect(math != nullptr and math->root() != nullptr);
+    expect(math->imports.size() == 1u);
+
+    auto missing = loader.load("../../tests/data/modules/missing.clr");
+    expect(not missing.has_value());
+    expect(missing.error().size() == 1u);
+    expect(missing.error()[0].kind == claire::DiagnosticKind::eModuleNotFound);
+  };
+
+  "modules.stdlib"_test = []() {
+    // The standard library is searched past the program's own modules
+    auto loader  = ModuleLoader{{"../../tests/data/modules", stdlib_path}, 2};
+    auto program = loader.load("../../tests/data/modules/hello.clr");
+    expect(program.has_value());
+
+    auto const *io = loader.registry().find(claire::intern("IO"));
+    expect(io != nullptr and io->root() != nullptr);
+    if (not io or not io->root()) {
+      return;
+    }
+    auto const *puts = node_cast<ExternDecl>(*io->root()->children().begin());
+    expect(puts != nullptr and puts->id() == claire::intern("puts"));
+  };
+
+  "modules.cache"_test = []() {
+    auto cache = ModuleCache{};
+    auto first = ModuleLoader{{"../../tests/data/modules"}, cache, 2};
+    expect(first.load("../../tests/data/modules/main.clr").has_value());
+
+    // Another build of the same sources parses none of them again
+    auto second = ModuleLoader{{"../../tests/data/modules"}, cache, 2};
+    expect(second.load("../../tests/data/modules/main.clr").has_value());
+    expect(cache.size() == 2u);
+
+    auto const math = claire::intern("Math");
+    expect(first.registry().find(math) == second.registry().find(math));
+  };
+
+  "modules.cache.throwing"_test = []() {
+    auto cache  = ModuleCache{};
+    auto key    = ModuleKey{"throwing.clr", 0};
+    auto waiter = std::thread{};
+    auto asking = std::atomic<bool>{};
+    auto waited = false;
+
+    // A request made while the module is being parsed waits on it, and gets the error
+    auto failing = [&](Module &) {
+      waiter = std::thread{[&]() {
+        asking = true;
+        try {
+          cache.get(key, [](Module &) {});
+        } catch (std::runtime_error const &) {
+          waited = true;
+        }
+      }};
+      // Leaves the waiter time to block on this parse
+      while (not asking) {
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds{50});
+      throw std::runtime_error{"unreadable"};
+    };
+    expect(throws([&]() { cache.get(key, failing); }));
+    waiter.join();
+    expect(waited);
+
+    // Later requests parse again, as the failure may not last
+    expect(cache.find(key) == nullptr);
+    auto const &module =
+      cache.get(key, [](Module &parsed) { parsed.path = "throwing.clr"; });
+    expect(module.path == "throwing.clr" and cache.find(key) == &module);
+  };
+
+  "modules.interfaces"_test = []() {
+    // Unique to this process, so that concurrent test runs do not share interfaces
+    auto dir = std::filesystem::temp_directory_path() /
+               ("claire-test-interfaces-" + std::to_string(::getpid()));
+    std::filesystem::remove_all(dir);
+
+    auto interfaces = ModuleInterfaceCache{dir};
+    auto cache      = ModuleCache{&interfaces};
+    auto loader     = ModuleLoader{{"../../tests/data/modules"}, cache, 2};
+    expect(loader.load("../../tests/data/modules/main.clr").has_value());
+
+    // Math is built again from the interface it was parsed into, with the same locations
+    auto const *math   = loader.registry().find(claire::intern("Math"));
+    auto        key    = module_key(math->path, *math->source);
+    auto        loaded = Module{math->name};
+    expect(interfaces.load(key, *math->source, loaded));
+
+    auto pp = ASTPrettyPrinter{};
+    expect(pp.pretty_print(loaded.root()) == pp.pretty_print(math->root()));
+    expect(loaded.imports.size() == 1u and loaded.imports[0].loc == math->imports[0].loc);
+
+    auto const *abs = node_cast<ExternDecl>(*++loaded.root()->children().begin());
+    expect(abs != nullptr and abs->linkage_name() == "abs");
+    expect(abs->args().size() == 1u and abs->return_type() == claire::intern("u32"));
+
+    // An interface of another version of the source is ignored
+    key.hash ^= 1;
+    expect(not interfaces.load(key, *math->source, loaded));
+
+    std::filesystem::remove_all(dir);
+  };
+
+  "flat"_test = []() {
+    auto pp = ASTPrettyPrinter{};
+
+    // my_func(a, std::puts)
+    std::vector<Token> const tokens{
+      {TokenKind::eLParens, "("},
+      {TokenKind::eIdentifier, "a"},
+      {TokenKind::eSeparator, ","},
+      {TokenKind::eIdentifier, "std"},
+      {TokenKind::eAccessNamespace, "::"},
+      {TokenKind::eIdentifier, "puts"},
+      {TokenKind::eRParens, ")"},
+    };
+
+    auto ctx    = parse_context{tokens};
+    auto callee = ctx.make<IdentifierExpr>(claire::intern("my_func"));
+    auto node   = parse_function_call_expression(ctx, callee);
+    auto flat   = FlatAST{node.value()};
+    expect(pp.pretty_print(flat) == pp.pretty_print(node.value()));
+
+    // The callee is laid out past the end of the tree
+    expect(flat.root().callee().index() == flat.nodes().front().end);
+    expect(flat.root().callee().id() == claire::intern("my_func"));
+
+    std::ptrdiff_t children{};
+    for (auto child : flat.root().children()) {
+      expect(child.level() == 1u);
+      ++children;
+    }
+    expect(children == std::ranges::distance(node.value()->children()));
+
+    // Whole programs flatten to as many nodes as they hold
+    auto source  = claire::Source{"../../examples/hello_world.clr"};
+    auto program = Parser{}.parse(Lexer{source}.tokenize());
+    auto tree    = FlatAST{program.value().root()};
+    expect(pp.pretty_print(tree) == pp.pretty_print(program.value().root()));
   };
 }